@@ -0,0 +1,109 @@
+// Copyright (c) 2022-present Tim Verberne
+// This source code is part of the Adaptive Ambience System plugin.
+
+#include "AmbiverseBudgetCommandlet.h"
+#include "AmbiverseBudget.h"
+#include "AmbiverseComposite.h"
+#include "AmbiverseElement.h"
+#include "AmbiverseLayer.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UAmbiverseBudgetCommandlet::UAmbiverseBudgetCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UAmbiverseBudgetCommandlet::Main(const FString& Params)
+{
+	FString OutputPath;
+	if (!FParse::Value(*Params, TEXT("Output="), OutputPath))
+	{
+		OutputPath = FPaths::ProjectSavedDir() / TEXT("Ambiverse") / TEXT("Budget.csv");
+	}
+
+	TArray<FString> Lines;
+	Lines.Add(TEXT("Type,Asset,FiresPerSecond,ConcurrentVoices,SoundMemoryMB,TracesPerSecond,ExceededBudgets"));
+
+	int32 OverBudgetCount {0};
+
+	for (UObject* Asset : LoadAssetsOfClass(UAmbiverseComposite::StaticClass()))
+	{
+		const UAmbiverseComposite* Composite {CastChecked<UAmbiverseComposite>(Asset)};
+		const FAmbiverseBudgetEstimate Estimate {FAmbiverseBudgetEstimate::EstimateComposite(Composite)};
+		const TArray<FText> ExceededBudgets {Estimate.GetExceededBudgets(Composite->Budget)};
+
+		for (const FText& ExceededBudget : ExceededBudgets)
+		{
+			UE_LOG(LogAmbiverseBudgetCommandlet, Error, TEXT("Main: '%s' is over budget. %s"), *Composite->GetPathName(), *ExceededBudget.ToString());
+		}
+		
+		OverBudgetCount += ExceededBudgets.IsEmpty() ? 0 : 1;
+		Lines.Add(FormatRow(TEXT("Composite"), Composite, Estimate, ExceededBudgets));
+	}
+
+	/** Layers and elements have no budget of their own. They are reported so the most expensive parts of a composite can be found. */
+	for (UObject* Asset : LoadAssetsOfClass(UAmbiverseLayer::StaticClass()))
+	{
+		TSet<const UObject*> CountedSounds;
+		Lines.Add(FormatRow(TEXT("Layer"), Asset, FAmbiverseBudgetEstimate::EstimateLayer(CastChecked<UAmbiverseLayer>(Asset), CountedSounds), {}));
+	}
+
+	/** Outside of a layer an element has no fire rate, so only the memory of its sounds is estimated. */
+	for (UObject* Asset : LoadAssetsOfClass(UAmbiverseElement::StaticClass()))
+	{
+		TSet<const UObject*> CountedSounds;
+		Lines.Add(FormatRow(TEXT("Element"), Asset, FAmbiverseBudgetEstimate::EstimateElement(CastChecked<UAmbiverseElement>(Asset), 0.0f, 0.0f, CountedSounds), {}));
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *OutputPath))
+	{
+		UE_LOG(LogAmbiverseBudgetCommandlet, Error, TEXT("Main: Unable to write the report to '%s'."), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogAmbiverseBudgetCommandlet, Display, TEXT("Main: Wrote the report to '%s'. %d composites are over budget."), *OutputPath, OverBudgetCount);
+	
+	return OverBudgetCount > 0 ? 1 : 0;
+}
+
+TArray<UObject*> UAmbiverseBudgetCommandlet::LoadAssetsOfClass(const UClass* Class)
+{
+	IAssetRegistry& AssetRegistry {FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get()};
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> AssetDataList;
+	AssetRegistry.GetAssetsByClass(Class->GetClassPathName(), AssetDataList, true);
+
+	TArray<UObject*> Assets;
+	for (const FAssetData& AssetData : AssetDataList)
+	{
+		if (UObject* Asset {AssetData.GetAsset()})
+		{
+			Assets.Add(Asset);
+		}
+		else
+		{
+			UE_LOG(LogAmbiverseBudgetCommandlet, Warning, TEXT("LoadAssetsOfClass: Unable to load '%s'."), *AssetData.GetObjectPathString());
+		}
+	}
+	
+	return Assets;
+}
+
+FString UAmbiverseBudgetCommandlet::FormatRow(const TCHAR* Type, const UObject* Asset, const FAmbiverseBudgetEstimate& Estimate,
+	const TArray<FText>& ExceededBudgets)
+{
+	TArray<FString> Messages;
+	for (const FText& ExceededBudget : ExceededBudgets)
+	{
+		Messages.Add(ExceededBudget.ToString());
+	}
+	
+	return FString::Printf(TEXT("%s,%s,%.3f,%.3f,%.3f,%.3f,\"%s\""), Type, *Asset->GetPathName(), Estimate.FiresPerSecond, Estimate.ConcurrentVoices,
+		static_cast<float>(Estimate.SoundMemoryBytes) / (1024.0f * 1024.0f), Estimate.TracesPerSecond, *FString::Join(Messages, TEXT(" ")));
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2022-present Tim Verberne
+// This source code is part of the Adaptive Ambience System plugin.
+
+#include "AmbiverseCommandletUtils.h"
+#include "AmbiverseSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+UWorld* FAmbiverseCommandletUtils::CreateWorld(const TCHAR* Name)
+{
+	UWorld* World {UWorld::CreateWorld(EWorldType::Game, false, Name)};
+	
+	FWorldContext& WorldContext {GEngine->CreateNewWorldContext(EWorldType::Game)};
+	WorldContext.SetCurrentWorld(World);
+	
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+	
+	return World;
+}
+
+void FAmbiverseCommandletUtils::DestroyWorld(UWorld* World)
+{
+	if (!World) { return; }
+	
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+}
+
+AActor* FAmbiverseCommandletUtils::SpawnListener(UWorld* World, UAmbiverseSubsystem* Subsystem)
+{
+	if (!World || !Subsystem) { return nullptr; }
+	
+	AActor* Listener {World->SpawnActor<AActor>()};
+	
+	USceneComponent* Root {NewObject<USceneComponent>(Listener, TEXT("Root"))};
+	Listener->SetRootComponent(Root);
+	Root->RegisterComponent();
+	
+	Subsystem->RegisterListener(Listener);
+	return Listener;
+}
+
+void FAmbiverseCommandletUtils::TickSubsystem(UAmbiverseSubsystem* Subsystem, const float DeltaTime)
+{
+	if (!Subsystem) { return; }
+
+	/** The subsystem tick is private, but it can be called through the tickable interface. */
+	FTickableGameObject& Tickable {*Subsystem};
+	Tickable.Tick(DeltaTime);
+}
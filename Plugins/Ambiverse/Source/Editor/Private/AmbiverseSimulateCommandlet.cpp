@@ -0,0 +1,364 @@
+// Copyright (c) 2022-present Tim Verberne
+// This source code is part of the Adaptive Ambience System plugin.
+
+#include "AmbiverseSimulateCommandlet.h"
+#include "AmbiverseCommandletUtils.h"
+#include "AmbiverseComposite.h"
+#include "AmbiverseElement.h"
+#include "AmbiverseLayer.h"
+#include "AmbiverseLayerManager.h"
+#include "AmbiverseParameter.h"
+#include "AmbiverseParameterManager.h"
+#include "AmbiverseSubsystem.h"
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+UAmbiverseSimulateCommandlet::UAmbiverseSimulateCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UAmbiverseSimulateCommandlet::Main(const FString& Params)
+{
+	const FSettings Settings {ParseSettings(Params)};
+
+	const TArray<UAmbiverseLayer*> Layers {LoadLayers(Settings)};
+	if (Layers.IsEmpty())
+	{
+		UE_LOG(LogAmbiverseSimulateCommandlet, Error, TEXT("Main: No layers to simulate. Provide composites or layers with -Assets=<Path>[+<Path>...]."));
+		return 1;
+	}
+
+	UWorld* World {FAmbiverseCommandletUtils::CreateWorld(TEXT("AmbiverseSimulate"))};
+	
+	UAmbiverseSubsystem* Subsystem {World->GetSubsystem<UAmbiverseSubsystem>()};
+	UAmbiverseLayerManager* LayerManager {Subsystem ? Subsystem->GetLayerManager() : nullptr};
+	
+	if (!LayerManager)
+	{
+		UE_LOG(LogAmbiverseSimulateCommandlet, Error, TEXT("Main: Unable to create the AmbiverseSubsystem."));
+		FAmbiverseCommandletUtils::DestroyWorld(World);
+		return 1;
+	}
+
+	/** Sound variants are selected with the global random stream, so it is seeded as well. */
+	FMath::RandInit(Settings.Seed);
+	Subsystem->SetRandomSeed(Settings.Seed);
+	Subsystem->SetSimulationMode(true);
+	
+	ApplyParameterValues(Settings, Subsystem->GetParameterManager());
+
+	TArray<FEvent> Events;
+	double Clock {0.0};
+
+	/** The subsystem does not place or play sounds in simulation mode, so the variant and location are resolved here. */
+	const FDelegateHandle Handle {Subsystem->OnElementFired.AddLambda([&Events, &Clock, &Settings](const UAmbiverseLayer* Layer, const FAmbiverseProceduralElement& ProceduralElement,
+		const float Lateness)
+	{
+		const UAmbiverseElement* Element {ProceduralElement.Element};
+		if (!Layer || !Element) { return; }
+		
+		FEvent& Event {Events.AddDefaulted_GetRef()};
+		Event.Time = Clock - Lateness;
+		Event.Layer = Layer->GetName();
+		Event.Element = Element->GetName();
+
+		const UMetaSoundSource* Sound {UAmbiverseElement::GetSoundFromMap(Element->Sounds)};
+		const float SoundDuration {Sound ? Sound->GetDuration() : 0.0f};
+		
+		Event.Variant = Sound ? Sound->GetName() : FString();
+		Event.Duration = SoundDuration > 0.0f && SoundDuration < INDEFINITELY_LOOPING_DURATION ? SoundDuration : Settings.VoiceDuration;
+
+		/** The listener travels along the X axis at a constant speed. Distributors require scene geometry, so only the distribution data is used. */
+		const FVector ListenerLocation {Settings.ListenerSpeed * Event.Time, 0.0, 0.0};
+		Event.Location = FAmbiverseSoundDistributionData::GetSoundTransform(Element->DistributionData, ListenerLocation).GetLocation();
+	})};
+
+	for (UAmbiverseLayer* Layer : Layers)
+	{
+		LayerManager->RegisterAmbiverseLayer(Layer);
+	}
+
+	UE_LOG(LogAmbiverseSimulateCommandlet, Display, TEXT("Main: Simulating %.0f seconds of %d layers with a time step of %.3f seconds."),
+		Settings.Duration, Layers.Num(), Settings.DeltaTime);
+
+	const double StartTime {FPlatformTime::Seconds()};
+	
+	while (Clock < Settings.Duration)
+	{
+		Clock += Settings.DeltaTime;
+		FAmbiverseCommandletUtils::TickSubsystem(Subsystem, Settings.DeltaTime);
+	}
+
+	Subsystem->OnElementFired.Remove(Handle);
+
+	UE_LOG(LogAmbiverseSimulateCommandlet, Display, TEXT("Main: Simulated %d events in %.3f seconds."), Events.Num(), FPlatformTime::Seconds() - StartTime);
+
+	/** Events are recorded per tick, so events of different elements within the same tick can be out of order. */
+	Events.StableSort([](const FEvent& A, const FEvent& B) { return A.Time < B.Time; });
+
+	TMap<FString, FConcurrency> Concurrency;
+	Concurrency.Add(TEXT("All"), GetConcurrency(Events, Settings.Duration));
+	
+	for (const UAmbiverseLayer* Layer : Layers)
+	{
+		const FString LayerName {Layer->GetName()};
+		Concurrency.Add(LayerName, GetConcurrency(Events, Settings.Duration, &LayerName));
+	}
+
+	for (const TPair<FString, FConcurrency>& Pair : Concurrency)
+	{
+		UE_LOG(LogAmbiverseSimulateCommandlet, Display, TEXT("%-32s peak %d voices"), *Pair.Key, Pair.Value.PeakVoiceCount);
+	}
+
+	const bool IsWritten {Settings.IsCsv ? WriteCsv(Settings, Events, Concurrency) : WriteJson(Settings, Events, Concurrency)};
+
+	FAmbiverseCommandletUtils::DestroyWorld(World);
+
+	return IsWritten ? 0 : 1;
+}
+
+UAmbiverseSimulateCommandlet::FSettings UAmbiverseSimulateCommandlet::ParseSettings(const FString& Params)
+{
+	FSettings Settings;
+
+	FString Assets;
+	if (FParse::Value(*Params, TEXT("Assets="), Assets, false))
+	{
+		Assets.ParseIntoArray(Settings.AssetPaths, TEXT("+"));
+	}
+
+	FString Parameters;
+	if (FParse::Value(*Params, TEXT("Parameters="), Parameters, false))
+	{
+		TArray<FString> Entries;
+		Parameters.ParseIntoArray(Entries, TEXT("+"));
+		
+		for (const FString& Entry : Entries)
+		{
+			FString Path;
+			FString Value;
+			if (Entry.Split(TEXT(":"), &Path, &Value, ESearchCase::IgnoreCase, ESearchDir::FromEnd))
+			{
+				Settings.ParameterValues.Emplace(Path, FCString::Atof(*Value));
+			}
+		}
+	}
+	
+	FParse::Value(*Params, TEXT("Duration="), Settings.Duration);
+	FParse::Value(*Params, TEXT("DeltaTime="), Settings.DeltaTime);
+	FParse::Value(*Params, TEXT("ListenerSpeed="), Settings.ListenerSpeed);
+	FParse::Value(*Params, TEXT("VoiceDuration="), Settings.VoiceDuration);
+	FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+
+	FString Format;
+	FParse::Value(*Params, TEXT("Format="), Format);
+	Settings.IsCsv = Format.Equals(TEXT("Csv"), ESearchCase::IgnoreCase);
+
+	Settings.Duration = FMath::Max(1.0, Settings.Duration);
+	Settings.DeltaTime = FMath::Max(UE_KINDA_SMALL_NUMBER, Settings.DeltaTime);
+	Settings.VoiceDuration = FMath::Max(0.0f, Settings.VoiceDuration);
+
+	if (!FParse::Value(*Params, TEXT("Output="), Settings.OutputPath))
+	{
+		Settings.OutputPath = FPaths::ProjectSavedDir() / TEXT("Ambiverse") / (Settings.IsCsv ? TEXT("Simulation.csv") : TEXT("Simulation.json"));
+	}
+	
+	return Settings;
+}
+
+TArray<UAmbiverseLayer*> UAmbiverseSimulateCommandlet::LoadLayers(const FSettings& Settings)
+{
+	TArray<UAmbiverseLayer*> Layers;
+	
+	for (const FString& AssetPath : Settings.AssetPaths)
+	{
+		UObject* Asset {StaticLoadObject(UObject::StaticClass(), nullptr, *AssetPath)};
+		
+		if (UAmbiverseComposite* Composite {Cast<UAmbiverseComposite>(Asset)})
+		{
+			for (UAmbiverseLayer* Layer : Composite->Layers)
+			{
+				if (Layer) { Layers.AddUnique(Layer); }
+			}
+		}
+		else if (UAmbiverseLayer* Layer {Cast<UAmbiverseLayer>(Asset)})
+		{
+			Layers.AddUnique(Layer);
+		}
+		else
+		{
+			UE_LOG(LogAmbiverseSimulateCommandlet, Warning, TEXT("LoadLayers: '%s' is not an Ambiverse composite or layer."), *AssetPath);
+		}
+	}
+	
+	return Layers;
+}
+
+void UAmbiverseSimulateCommandlet::ApplyParameterValues(const FSettings& Settings, UAmbiverseParameterManager* ParameterManager)
+{
+	if (!ParameterManager) { return; }
+	
+	for (const TPair<FString, float>& ParameterValue : Settings.ParameterValues)
+	{
+		UAmbiverseParameter* Parameter {LoadObject<UAmbiverseParameter>(nullptr, *ParameterValue.Key)};
+		if (!Parameter)
+		{
+			UE_LOG(LogAmbiverseSimulateCommandlet, Warning, TEXT("ApplyParameterValues: Unable to load parameter '%s'."), *ParameterValue.Key);
+			continue;
+		}
+		
+		ParameterManager->RegisterParameter(Parameter);
+		ParameterManager->SetParameterValue(Parameter, ParameterValue.Value);
+	}
+}
+
+UAmbiverseSimulateCommandlet::FConcurrency UAmbiverseSimulateCommandlet::GetConcurrency(const TArray<FEvent>& Events, const double Duration,
+	const FString* Layer)
+{
+	/** Every voice adds a start and an end edge. Edges at the same time are ordered so that ending voices are removed first. */
+	TArray<TPair<double, int32>> Edges;
+	Edges.Reserve(Events.Num() * 2);
+	
+	for (const FEvent& Event : Events)
+	{
+		if (Layer && Event.Layer != *Layer) { continue; }
+		
+		Edges.Emplace(Event.Time, 1);
+		Edges.Emplace(Event.Time + Event.Duration, -1);
+	}
+	
+	Edges.Sort([](const TPair<double, int32>& A, const TPair<double, int32>& B)
+	{
+		return A.Key < B.Key || (A.Key == B.Key && A.Value < B.Value);
+	});
+
+	FConcurrency Concurrency;
+	Concurrency.SecondsPerVoiceCount.Init(0.0, 1);
+	
+	int32 VoiceCount {0};
+	double PreviousTime {0.0};
+	
+	for (const TPair<double, int32>& Edge : Edges)
+	{
+		/** Voices that are still playing at the end of the simulation are not counted beyond it. */
+		const double Time {FMath::Min(Edge.Key, Duration)};
+		Concurrency.SecondsPerVoiceCount[VoiceCount] += FMath::Max(0.0, Time - PreviousTime);
+		PreviousTime = FMath::Max(PreviousTime, Time);
+
+		VoiceCount += Edge.Value;
+		Concurrency.PeakVoiceCount = FMath::Max(Concurrency.PeakVoiceCount, VoiceCount);
+		
+		if (Concurrency.SecondsPerVoiceCount.Num() <= VoiceCount)
+		{
+			Concurrency.SecondsPerVoiceCount.SetNumZeroed(VoiceCount + 1);
+		}
+	}
+
+	Concurrency.SecondsPerVoiceCount[VoiceCount] += FMath::Max(0.0, Duration - PreviousTime);
+	
+	return Concurrency;
+}
+
+bool UAmbiverseSimulateCommandlet::WriteJson(const FSettings& Settings, const TArray<FEvent>& Events, const TMap<FString, FConcurrency>& Concurrency)
+{
+	TArray<TSharedPtr<FJsonValue>> EventValues;
+	EventValues.Reserve(Events.Num());
+	
+	for (const FEvent& Event : Events)
+	{
+		TSharedRef<FJsonObject> EventObject {MakeShared<FJsonObject>()};
+		EventObject->SetNumberField(TEXT("Time"), Event.Time);
+		EventObject->SetNumberField(TEXT("Duration"), Event.Duration);
+		EventObject->SetStringField(TEXT("Layer"), Event.Layer);
+		EventObject->SetStringField(TEXT("Element"), Event.Element);
+		EventObject->SetStringField(TEXT("Variant"), Event.Variant);
+		EventObject->SetArrayField(TEXT("Location"), {
+			MakeShared<FJsonValueNumber>(Event.Location.X),
+			MakeShared<FJsonValueNumber>(Event.Location.Y),
+			MakeShared<FJsonValueNumber>(Event.Location.Z)});
+		EventValues.Add(MakeShared<FJsonValueObject>(EventObject));
+	}
+
+	TSharedRef<FJsonObject> ConcurrencyObject {MakeShared<FJsonObject>()};
+	for (const TPair<FString, FConcurrency>& Pair : Concurrency)
+	{
+		TArray<TSharedPtr<FJsonValue>> HistogramValues;
+		for (const double Seconds : Pair.Value.SecondsPerVoiceCount)
+		{
+			HistogramValues.Add(MakeShared<FJsonValueNumber>(Seconds));
+		}
+		
+		TSharedRef<FJsonObject> LayerObject {MakeShared<FJsonObject>()};
+		LayerObject->SetNumberField(TEXT("PeakVoices"), Pair.Value.PeakVoiceCount);
+		LayerObject->SetArrayField(TEXT("SecondsPerVoiceCount"), HistogramValues);
+		ConcurrencyObject->SetObjectField(Pair.Key, LayerObject);
+	}
+
+	TSharedRef<FJsonObject> SettingsObject {MakeShared<FJsonObject>()};
+	SettingsObject->SetNumberField(TEXT("Duration"), Settings.Duration);
+	SettingsObject->SetNumberField(TEXT("DeltaTime"), Settings.DeltaTime);
+	SettingsObject->SetNumberField(TEXT("ListenerSpeed"), Settings.ListenerSpeed);
+	SettingsObject->SetNumberField(TEXT("VoiceDuration"), Settings.VoiceDuration);
+	SettingsObject->SetNumberField(TEXT("Seed"), Settings.Seed);
+
+	TSharedRef<FJsonObject> RootObject {MakeShared<FJsonObject>()};
+	RootObject->SetObjectField(TEXT("Settings"), SettingsObject);
+	RootObject->SetArrayField(TEXT("Events"), EventValues);
+	RootObject->SetObjectField(TEXT("Concurrency"), ConcurrencyObject);
+
+	FString Output;
+	const TSharedRef<TJsonWriter<>> Writer {TJsonWriterFactory<>::Create(&Output)};
+	FJsonSerializer::Serialize(RootObject, Writer);
+
+	if (!FFileHelper::SaveStringToFile(Output, *Settings.OutputPath))
+	{
+		UE_LOG(LogAmbiverseSimulateCommandlet, Error, TEXT("WriteJson: Unable to write results to '%s'."), *Settings.OutputPath);
+		return false;
+	}
+
+	UE_LOG(LogAmbiverseSimulateCommandlet, Display, TEXT("WriteJson: Wrote results to '%s'."), *Settings.OutputPath);
+	return true;
+}
+
+bool UAmbiverseSimulateCommandlet::WriteCsv(const FSettings& Settings, const TArray<FEvent>& Events, const TMap<FString, FConcurrency>& Concurrency)
+{
+	/** The timeline and the histograms have different columns, so the histograms are written to a second file. */
+	TArray<FString> TimelineLines;
+	TimelineLines.Reserve(Events.Num() + 1);
+	TimelineLines.Add(TEXT("Time,Duration,Layer,Element,Variant,X,Y,Z"));
+	
+	for (const FEvent& Event : Events)
+	{
+		TimelineLines.Add(FString::Printf(TEXT("%.4f,%.4f,%s,%s,%s,%.1f,%.1f,%.1f"), Event.Time, Event.Duration, *Event.Layer, *Event.Element,
+			*Event.Variant, Event.Location.X, Event.Location.Y, Event.Location.Z));
+	}
+
+	TArray<FString> ConcurrencyLines;
+	ConcurrencyLines.Add(TEXT("Layer,Voices,Seconds"));
+	
+	for (const TPair<FString, FConcurrency>& Pair : Concurrency)
+	{
+		for (int32 VoiceCount {0}; VoiceCount < Pair.Value.SecondsPerVoiceCount.Num(); ++VoiceCount)
+		{
+			ConcurrencyLines.Add(FString::Printf(TEXT("%s,%d,%.4f"), *Pair.Key, VoiceCount, Pair.Value.SecondsPerVoiceCount[VoiceCount]));
+		}
+	}
+
+	const FString ConcurrencyPath {FPaths::GetPath(Settings.OutputPath) / FPaths::GetBaseFilename(Settings.OutputPath) + TEXT("_Concurrency.csv")};
+
+	if (!FFileHelper::SaveStringArrayToFile(TimelineLines, *Settings.OutputPath) || !FFileHelper::SaveStringArrayToFile(ConcurrencyLines, *ConcurrencyPath))
+	{
+		UE_LOG(LogAmbiverseSimulateCommandlet, Error, TEXT("WriteCsv: Unable to write results to '%s'."), *Settings.OutputPath);
+		return false;
+	}
+
+	UE_LOG(LogAmbiverseSimulateCommandlet, Display, TEXT("WriteCsv: Wrote results to '%s' and '%s'."), *Settings.OutputPath, *ConcurrencyPath);
+	return true;
+}
@@ -0,0 +1,534 @@
+// Copyright (c) 2022-present Tim Verberne
+// This source code is part of the Adaptive Ambience System plugin.
+
+#include "AmbiverseCommandletUtils.h"
+#include "AmbiverseElement.h"
+#include "AmbiverseLayer.h"
+#include "AmbiverseLayerManager.h"
+#include "AmbiverseParameter.h"
+#include "AmbiverseParameterManager.h"
+#include "AmbiverseSoundSource.h"
+#include "AmbiverseSoundSourceManager.h"
+#include "AmbiverseSubsystem.h"
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Benchmarks of the Ambiverse runtime in a headless world. Every test writes its timings, counters and memory deltas to a JSON report.
+ *	Usage: UnrealEditor-Cmd <Project> -ExecCmds="Automation RunTests Ambiverse.Benchmark; Quit" -nullrhi -unattended
+ *	[-AmbiverseBenchmark="Layers=4 Elements=16 IntervalMin=0.5 IntervalMax=2 Parameters=2 Sounds=4 Frames=3600 DeltaTime=0.0166667
+ *	ListenerSpeed=500 Iterations=10000 Seed=0 Output=<Directory>"] [-llm] */
+namespace AmbiverseBenchmark
+{
+	constexpr EAutomationTestFlags::Type TestFlags {EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter};
+
+	struct FSettings
+	{
+		int32 LayerCount {4};
+		int32 ElementCount {16};
+		float IntervalMin {0.5f};
+		float IntervalMax {2.0f};
+		int32 ParameterCount {2};
+		int32 SoundCount {4};
+		int32 FrameCount {3600};
+		float DeltaTime {1.0f / 60.0f};
+		float ListenerSpeed {500.0f};
+		int32 IterationCount {10000};
+		int32 Seed {0};
+		FString OutputDirectory;
+
+		/** Reads the settings from the -AmbiverseBenchmark="..." command line argument. */
+		static FSettings FromCommandLine()
+		{
+			FString Params;
+			FParse::Value(FCommandLine::Get(), TEXT("AmbiverseBenchmark="), Params, false);
+
+			FSettings Settings;
+			FParse::Value(*Params, TEXT("Layers="), Settings.LayerCount);
+			FParse::Value(*Params, TEXT("Elements="), Settings.ElementCount);
+			FParse::Value(*Params, TEXT("IntervalMin="), Settings.IntervalMin);
+			FParse::Value(*Params, TEXT("IntervalMax="), Settings.IntervalMax);
+			FParse::Value(*Params, TEXT("Parameters="), Settings.ParameterCount);
+			FParse::Value(*Params, TEXT("Sounds="), Settings.SoundCount);
+			FParse::Value(*Params, TEXT("Frames="), Settings.FrameCount);
+			FParse::Value(*Params, TEXT("DeltaTime="), Settings.DeltaTime);
+			FParse::Value(*Params, TEXT("ListenerSpeed="), Settings.ListenerSpeed);
+			FParse::Value(*Params, TEXT("Iterations="), Settings.IterationCount);
+			FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+
+			Settings.LayerCount = FMath::Max(1, Settings.LayerCount);
+			Settings.ElementCount = FMath::Max(1, Settings.ElementCount);
+			Settings.SoundCount = FMath::Max(1, Settings.SoundCount);
+			Settings.ParameterCount = FMath::Max(0, Settings.ParameterCount);
+			Settings.FrameCount = FMath::Max(1, Settings.FrameCount);
+			Settings.DeltaTime = FMath::Max(UE_KINDA_SMALL_NUMBER, Settings.DeltaTime);
+			Settings.IntervalMin = FMath::Max(UE_KINDA_SMALL_NUMBER, Settings.IntervalMin);
+			Settings.IntervalMax = FMath::Max(Settings.IntervalMin, Settings.IntervalMax);
+			Settings.IterationCount = FMath::Max(1, Settings.IterationCount);
+
+			if (!FParse::Value(*Params, TEXT("Output="), Settings.OutputDirectory))
+			{
+				Settings.OutputDirectory = FPaths::ProjectSavedDir() / TEXT("Ambiverse") / TEXT("Benchmark");
+			}
+
+			return Settings;
+		}
+
+		TSharedRef<FJsonObject> ToJson() const
+		{
+			TSharedRef<FJsonObject> Object {MakeShared<FJsonObject>()};
+			Object->SetNumberField(TEXT("Layers"), LayerCount);
+			Object->SetNumberField(TEXT("Elements"), ElementCount);
+			Object->SetNumberField(TEXT("IntervalMin"), IntervalMin);
+			Object->SetNumberField(TEXT("IntervalMax"), IntervalMax);
+			Object->SetNumberField(TEXT("Parameters"), ParameterCount);
+			Object->SetNumberField(TEXT("Sounds"), SoundCount);
+			Object->SetNumberField(TEXT("Frames"), FrameCount);
+			Object->SetNumberField(TEXT("DeltaTime"), DeltaTime);
+			Object->SetNumberField(TEXT("ListenerSpeed"), ListenerSpeed);
+			Object->SetNumberField(TEXT("Iterations"), IterationCount);
+			Object->SetNumberField(TEXT("Seed"), Seed);
+			return Object;
+		}
+	};
+
+	/** Timings of a single measured stage. */
+	struct FStageResult
+	{
+		FString Name;
+		int32 SampleCount {0};
+		double TotalSeconds {0.0};
+		double MinSeconds {TNumericLimits<double>::Max()};
+		double MaxSeconds {0.0};
+		TArray<double> Samples;
+
+		/** The change in memory tracked by the low level memory tracker over the stage, or INDEX_NONE if it is not enabled. */
+		int64 TrackedMemoryDelta {INDEX_NONE};
+
+		void AddSample(const double Seconds)
+		{
+			++SampleCount;
+			TotalSeconds += Seconds;
+			MinSeconds = FMath::Min(MinSeconds, Seconds);
+			MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+			Samples.Add(Seconds);
+		}
+
+		double GetMeanSeconds() const { return SampleCount > 0 ? TotalSeconds / SampleCount : 0.0; }
+
+		TSharedRef<FJsonObject> ToJson() const
+		{
+			TArray<double> SortedSamples {Samples};
+			SortedSamples.Sort();
+			const double P95Seconds {SortedSamples.IsEmpty() ? 0.0 : SortedSamples[FMath::Min(SortedSamples.Num() - 1, FMath::FloorToInt(SortedSamples.Num() * 0.95))]};
+
+			TSharedRef<FJsonObject> Object {MakeShared<FJsonObject>()};
+			Object->SetStringField(TEXT("Name"), Name);
+			Object->SetNumberField(TEXT("Samples"), SampleCount);
+			Object->SetNumberField(TEXT("TotalMs"), TotalSeconds * 1000.0);
+			Object->SetNumberField(TEXT("MeanUs"), GetMeanSeconds() * 1000000.0);
+			Object->SetNumberField(TEXT("MinUs"), SampleCount > 0 ? MinSeconds * 1000000.0 : 0.0);
+			Object->SetNumberField(TEXT("MaxUs"), MaxSeconds * 1000000.0);
+			Object->SetNumberField(TEXT("P95Us"), P95Seconds * 1000000.0);
+			if (TrackedMemoryDelta != INDEX_NONE)
+			{
+				Object->SetNumberField(TEXT("TrackedMemoryDeltaBytes"), static_cast<double>(TrackedMemoryDelta));
+			}
+			return Object;
+		}
+	};
+
+	/** Returns the memory of all live allocations, or INDEX_NONE if the low level memory tracker is not enabled with -llm.
+	 *	Unlike the used physical memory of the process, this does not include memory that is cached by the allocator. */
+	int64 GetTrackedMemory()
+	{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		if (FLowLevelMemTracker::Get().IsEnabled())
+		{
+			return static_cast<int64>(FLowLevelMemTracker::Get().GetTotalTrackedMemory(ELLMTracker::Default));
+		}
+#endif
+		return INDEX_NONE;
+	}
+
+	int64 GetTrackedMemoryDelta(const int64 TrackedMemoryBefore)
+	{
+		const int64 TrackedMemoryAfter {GetTrackedMemory()};
+		return TrackedMemoryBefore == INDEX_NONE || TrackedMemoryAfter == INDEX_NONE ? INDEX_NONE : TrackedMemoryAfter - TrackedMemoryBefore;
+	}
+
+	/** Calls a function repeatedly and records the time of every batch of calls.
+	 *	Calls are timed in batches, as the timer resolution is too coarse for a single call. */
+	template <typename FunctionType>
+	FStageResult MeasureStage(const TCHAR* Name, const int32 IterationCount, FunctionType&& Function)
+	{
+		constexpr int32 BatchSize {100};
+
+		FStageResult Result;
+		Result.Name = Name;
+
+		const int64 TrackedMemoryBefore {GetTrackedMemory()};
+
+		for (int32 BatchStart {0}; BatchStart < IterationCount; BatchStart += BatchSize)
+		{
+			const int32 BatchEnd {FMath::Min(BatchStart + BatchSize, IterationCount)};
+
+			const double StartTime {FPlatformTime::Seconds()};
+			for (int32 Index {BatchStart}; Index < BatchEnd; ++Index)
+			{
+				Function(Index);
+			}
+			Result.AddSample((FPlatformTime::Seconds() - StartTime) / (BatchEnd - BatchStart));
+		}
+
+		Result.TrackedMemoryDelta = GetTrackedMemoryDelta(TrackedMemoryBefore);
+		return Result;
+	}
+
+	/** A headless world with the Ambiverse subsystem, a listener and registered synthetic layers. The world is destroyed with the context. */
+	class FBenchmarkContext
+	{
+	public:
+		FSettings Settings {FSettings::FromCommandLine()};
+
+		UWorld* World {nullptr};
+		UAmbiverseSubsystem* Subsystem {nullptr};
+		UAmbiverseLayerManager* LayerManager {nullptr};
+		UAmbiverseParameterManager* ParameterManager {nullptr};
+		UAmbiverseSoundSourceManager* SoundSourceManager {nullptr};
+		AActor* Listener {nullptr};
+		TArray<UAmbiverseLayer*> Layers;
+
+		explicit FBenchmarkContext(FAutomationTestBase& InTest)
+			: Test(InTest)
+		{
+			/** The runtime uses the global random stream, so seeding it makes runs comparable. */
+			FMath::RandInit(Settings.Seed);
+
+			World = FAmbiverseCommandletUtils::CreateWorld(TEXT("AmbiverseBenchmark"));
+			Subsystem = World->GetSubsystem<UAmbiverseSubsystem>();
+			LayerManager = Subsystem ? Subsystem->GetLayerManager() : nullptr;
+			ParameterManager = Subsystem ? Subsystem->GetParameterManager() : nullptr;
+			SoundSourceManager = Subsystem ? Subsystem->GetSoundSourceManager() : nullptr;
+
+			if (!LayerManager || !ParameterManager || !SoundSourceManager)
+			{
+				Test.AddError(TEXT("Unable to create the AmbiverseSubsystem."));
+				return;
+			}
+
+			Subsystem->SetRandomSeed(Settings.Seed);
+			Listener = FAmbiverseCommandletUtils::SpawnListener(World, Subsystem);
+
+			Layers = CreateSyntheticLayers();
+			for (UAmbiverseLayer* Layer : Layers)
+			{
+				LayerManager->RegisterAmbiverseLayer(Layer);
+			}
+
+			if (GetTrackedMemory() == INDEX_NONE)
+			{
+				Test.AddInfo(TEXT("Memory deltas are only reported when running with -llm."));
+			}
+		}
+
+		~FBenchmarkContext()
+		{
+			FAmbiverseCommandletUtils::DestroyWorld(World);
+		}
+
+		bool IsValid() const { return LayerManager && ParameterManager && SoundSourceManager; }
+
+		const UAmbiverseLayer* GetFirstLayer() const { return Layers[0]; }
+
+		/** Returns finished sound sources to the pool. Without an audio device, sounds finish immediately. */
+		void ReleaseFinishedSoundSources() const
+		{
+			for (AAmbiverseSoundSource* SoundSource : SoundSourceManager->GetActiveSoundSources())
+			{
+				if (SoundSource && (!SoundSource->GetAudioComponent() || !SoundSource->GetAudioComponent()->IsPlaying()))
+				{
+					SoundSourceManager->ReleaseToPool(SoundSource);
+				}
+			}
+		}
+
+		/** Adds the stages to the test log and writes them to <OutputDirectory>/<Name>.json. */
+		bool WriteReport(const FString& Name, const TArray<FStageResult>& StageResults,
+			const TSharedRef<FJsonObject>& CountersObject = MakeShared<FJsonObject>()) const
+		{
+			TArray<TSharedPtr<FJsonValue>> StageValues;
+			for (const FStageResult& StageResult : StageResults)
+			{
+				StageValues.Add(MakeShared<FJsonValueObject>(StageResult.ToJson()));
+
+				Test.AddInfo(FString::Printf(TEXT("%-24s mean %10.3f us, max %10.3f us"), *StageResult.Name,
+					StageResult.GetMeanSeconds() * 1000000.0, StageResult.MaxSeconds * 1000000.0));
+			}
+
+			TSharedRef<FJsonObject> RootObject {MakeShared<FJsonObject>()};
+			RootObject->SetObjectField(TEXT("Settings"), Settings.ToJson());
+			RootObject->SetObjectField(TEXT("Counters"), CountersObject);
+			RootObject->SetArrayField(TEXT("Stages"), StageValues);
+
+			FString Output;
+			const TSharedRef<TJsonWriter<>> Writer {TJsonWriterFactory<>::Create(&Output)};
+			FJsonSerializer::Serialize(RootObject, Writer);
+
+			const FString OutputPath {Settings.OutputDirectory / Name + TEXT(".json")};
+			if (!FFileHelper::SaveStringToFile(Output, *OutputPath))
+			{
+				Test.AddError(FString::Printf(TEXT("Unable to write results to '%s'."), *OutputPath));
+				return false;
+			}
+
+			Test.AddInfo(FString::Printf(TEXT("Wrote results to '%s'."), *OutputPath));
+			return true;
+		}
+
+	private:
+		FAutomationTestBase& Test;
+
+		/** Creates layers with synthetic elements, sounds and parameters. */
+		TArray<UAmbiverseLayer*> CreateSyntheticLayers() const
+		{
+			UPackage* Package {GetTransientPackage()};
+
+			TArray<UMetaSoundSource*> Sounds;
+			for (int32 Index {0}; Index < Settings.SoundCount; ++Index)
+			{
+				Sounds.Add(NewObject<UMetaSoundSource>(Package, MakeUniqueObjectName(Package, UMetaSoundSource::StaticClass(), TEXT("BenchmarkSound")), RF_Transient));
+			}
+
+			TArray<UAmbiverseParameter*> Parameters;
+			for (int32 Index {0}; Index < Settings.ParameterCount; ++Index)
+			{
+				UAmbiverseParameter* Parameter {NewObject<UAmbiverseParameter>(Package,
+					MakeUniqueObjectName(Package, UAmbiverseParameter::StaticClass(), TEXT("BenchmarkParameter")), RF_Transient)};
+				Parameter->SetParameter(FMath::FRandRange(Parameter->ParameterRange.X, Parameter->ParameterRange.Y));
+				Parameters.Add(Parameter);
+			}
+
+			TArray<UAmbiverseLayer*> SyntheticLayers;
+			for (int32 LayerIndex {0}; LayerIndex < Settings.LayerCount; ++LayerIndex)
+			{
+				UAmbiverseLayer* Layer {NewObject<UAmbiverseLayer>(Package,
+					MakeUniqueObjectName(Package, UAmbiverseLayer::StaticClass(), TEXT("BenchmarkLayer")), RF_Transient)};
+
+				for (UAmbiverseParameter* Parameter : Parameters)
+				{
+					FAmbiverseParameterModifiers& Modifiers {Layer->Parameters.AddDefaulted_GetRef()};
+					Modifiers.Parameter = Parameter;
+					Modifiers.DensityRange = FVector2D(0.5, 2.0);
+					Modifiers.VolumeRange = FVector2D(0.5, 1.0);
+				}
+
+				for (int32 ElementIndex {0}; ElementIndex < Settings.ElementCount; ++ElementIndex)
+				{
+					UAmbiverseElement* Element {NewObject<UAmbiverseElement>(Layer, *FString::Printf(TEXT("BenchmarkElement_%d"), ElementIndex), RF_Transient)};
+
+					for (int32 SoundIndex {0}; SoundIndex < Sounds.Num(); ++SoundIndex)
+					{
+						Element->Sounds.Add(Sounds[SoundIndex], 1 + (ElementIndex + SoundIndex) % 4);
+					}
+
+					FAmbiverseProceduralElement& ProceduralElement {Layer->ProceduralElements.AddDefaulted_GetRef()};
+					ProceduralElement.Element = Element;
+					ProceduralElement.IntervalRange = FVector2D(Settings.IntervalMin, Settings.IntervalMax);
+				}
+
+				SyntheticLayers.Add(Layer);
+			}
+
+			return SyntheticLayers;
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseBenchmarkFrameTest, "Ambiverse.Benchmark.Frame", AmbiverseBenchmark::TestFlags)
+
+/** Ticks the world for a number of frames, with the listener moving along the X axis.
+ *	The layer tick time is read from the frame counters of the subsystem, and covers UpdateElements and everything it triggers. */
+bool FAmbiverseBenchmarkFrameTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseBenchmark;
+
+	const FBenchmarkContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	const FSettings& Settings {Context.Settings};
+
+	FStageResult FrameResult;
+	FrameResult.Name = TEXT("Frame");
+	FStageResult LayerTickResult;
+	LayerTickResult.Name = TEXT("LayerTick");
+
+	FAmbiverseFrameCounters TotalCounters;
+	const int64 TrackedMemoryBefore {GetTrackedMemory()};
+
+	for (int32 Frame {0}; Frame < Settings.FrameCount; ++Frame)
+	{
+		Context.Listener->SetActorLocation(FVector(Settings.ListenerSpeed * Settings.DeltaTime * Frame, 0.0f, 0.0f));
+
+		const double StartTime {FPlatformTime::Seconds()};
+		Context.World->Tick(LEVELTICK_All, Settings.DeltaTime);
+		FrameResult.AddSample(FPlatformTime::Seconds() - StartTime);
+
+		const FAmbiverseFrameCounters& Counters {Context.Subsystem->GetLastFrameCounters()};
+		LayerTickResult.AddSample(Counters.LayerTickTime / 1000.0);
+		TotalCounters.Fires += Counters.Fires;
+		TotalCounters.Spawns += Counters.Spawns;
+		TotalCounters.PoolMisses += Counters.PoolMisses;
+		TotalCounters.Traces += Counters.Traces;
+
+		Context.ReleaseFinishedSoundSources();
+	}
+
+	FrameResult.TrackedMemoryDelta = GetTrackedMemoryDelta(TrackedMemoryBefore);
+
+	TSharedRef<FJsonObject> CountersObject {MakeShared<FJsonObject>()};
+	CountersObject->SetNumberField(TEXT("Fires"), TotalCounters.Fires);
+	CountersObject->SetNumberField(TEXT("Spawns"), TotalCounters.Spawns);
+	CountersObject->SetNumberField(TEXT("PoolMisses"), TotalCounters.PoolMisses);
+	CountersObject->SetNumberField(TEXT("Traces"), TotalCounters.Traces);
+	CountersObject->SetNumberField(TEXT("FiresPerSecond"), TotalCounters.Fires / FMath::Max(Settings.FrameCount * Settings.DeltaTime, UE_SMALL_NUMBER));
+
+	TestTrue(TEXT("Elements fired during the run"), TotalCounters.Fires > 0);
+
+	return Context.WriteReport(TEXT("Frame"), {FrameResult, LayerTickResult}, CountersObject);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseBenchmarkUpdateElementsTest, "Ambiverse.Benchmark.UpdateElements", AmbiverseBenchmark::TestFlags)
+
+/** Calls UpdateElements directly for each layer in turn. The subsystem is in simulation mode, so fired elements are only rescheduled,
+ *	and the stage measures the scheduler without placement or playback. */
+bool FAmbiverseBenchmarkUpdateElementsTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseBenchmark;
+
+	const FBenchmarkContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	Context.Subsystem->SetSimulationMode(true);
+	Context.Subsystem->GetFrameCounters().Reset();
+
+	const TArray<FAmbiverseListenerState>& Listeners {Context.Subsystem->GetListenerStates()};
+
+	const FStageResult Result {MeasureStage(TEXT("UpdateElements"), Context.Settings.IterationCount, [&Context, &Listeners](const int32 Index)
+	{
+		Context.LayerManager->UpdateElements(Context.Settings.DeltaTime, Context.Layers[Index % Context.Layers.Num()], Listeners);
+	})};
+
+	TSharedRef<FJsonObject> CountersObject {MakeShared<FJsonObject>()};
+	CountersObject->SetNumberField(TEXT("Fires"), Context.Subsystem->GetFrameCounters().Fires);
+
+	return Context.WriteReport(TEXT("UpdateElements"), {Result}, CountersObject);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseBenchmarkGetScalarsForElementTest, "Ambiverse.Benchmark.GetScalarsForElement", AmbiverseBenchmark::TestFlags)
+
+bool FAmbiverseBenchmarkGetScalarsForElementTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseBenchmark;
+
+	const FBenchmarkContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	const UAmbiverseLayer* Layer {Context.GetFirstLayer()};
+
+	const FStageResult Result {MeasureStage(TEXT("GetScalarsForElement"), Context.Settings.IterationCount, [&Context, Layer](const int32 Index)
+	{
+		float DensityScalar {1.0f};
+		float VolumeScalar {1.0f};
+		Context.ParameterManager->GetScalarsForElement(DensityScalar, VolumeScalar, Layer, Index % Layer->ProceduralElements.Num());
+	})};
+
+	return Context.WriteReport(TEXT("GetScalarsForElement"), {Result});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseBenchmarkGetSoundFromMapTest, "Ambiverse.Benchmark.GetSoundFromMap", AmbiverseBenchmark::TestFlags)
+
+bool FAmbiverseBenchmarkGetSoundFromMapTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseBenchmark;
+
+	const FBenchmarkContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	const UAmbiverseLayer* Layer {Context.GetFirstLayer()};
+
+	const FStageResult Result {MeasureStage(TEXT("GetSoundFromMap"), Context.Settings.IterationCount, [Layer](const int32 Index)
+	{
+		UAmbiverseElement::GetSoundFromMap(Layer->ProceduralElements[Index % Layer->ProceduralElements.Num()].Element->Sounds);
+	})};
+
+	return Context.WriteReport(TEXT("GetSoundFromMap"), {Result});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseBenchmarkGetSoundTransformTest, "Ambiverse.Benchmark.GetSoundTransform", AmbiverseBenchmark::TestFlags)
+
+bool FAmbiverseBenchmarkGetSoundTransformTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseBenchmark;
+
+	const FBenchmarkContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	const FAmbiverseSoundDistributionData& DistributionData {Context.GetFirstLayer()->ProceduralElements[0].Element->DistributionData};
+	int32 SpawnPointCursor {INDEX_NONE};
+
+	const FStageResult Result {MeasureStage(TEXT("GetSoundTransform"), Context.Settings.IterationCount, [&DistributionData, &SpawnPointCursor](const int32 Index)
+	{
+		FAmbiverseSoundDistributionData::GetSoundTransform(DistributionData, FVector::ZeroVector, SpawnPointCursor);
+	})};
+
+	return Context.WriteReport(TEXT("GetSoundTransform"), {Result});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseBenchmarkPoolChurnTest, "Ambiverse.Benchmark.PoolChurn", AmbiverseBenchmark::TestFlags)
+
+/** Acquires a sound source and returns it to the pool straight away. */
+bool FAmbiverseBenchmarkPoolChurnTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseBenchmark;
+
+	const FBenchmarkContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	FAmbiverseSoundSourceData SoundSourceData;
+	SoundSourceData.Sound = Context.GetFirstLayer()->ProceduralElements[0].Element->Sounds.CreateConstIterator()->Key;
+	SoundSourceData.Name = TEXT("BenchmarkSoundSource");
+
+	UAmbiverseSoundSourceManager* SoundSourceManager {Context.SoundSourceManager};
+	Context.Subsystem->GetFrameCounters().Reset();
+
+	const FStageResult Result {MeasureStage(TEXT("PoolChurn"), Context.Settings.IterationCount, [SoundSourceManager, &SoundSourceData](const int32 Index)
+	{
+		const int32 ActiveCount {SoundSourceManager->GetActiveSoundSourceCount()};
+		SoundSourceManager->InitiateSoundSource(SoundSourceData);
+
+		if (SoundSourceManager->GetActiveSoundSourceCount() > ActiveCount)
+		{
+			SoundSourceManager->ReleaseToPool(SoundSourceManager->GetActiveSoundSources().Last());
+		}
+	})};
+
+	/** Only the first request spawns a sound source, every later request is served from the pool. */
+	const FAmbiverseFrameCounters& Counters {Context.Subsystem->GetFrameCounters()};
+	TestTrue(TEXT("Sound sources are reused from the pool"), Counters.Spawns <= 1);
+
+	TSharedRef<FJsonObject> CountersObject {MakeShared<FJsonObject>()};
+	CountersObject->SetNumberField(TEXT("Spawns"), Counters.Spawns);
+	CountersObject->SetNumberField(TEXT("PoolMisses"), Counters.PoolMisses);
+
+	return Context.WriteReport(TEXT("PoolChurn"), {Result}, CountersObject);
+}
+
+#endif
@@ -0,0 +1,504 @@
+// Copyright (c) 2022-present Tim Verberne
+// This source code is part of the Adaptive Ambience System plugin.
+
+#include "AmbiverseCommandletUtils.h"
+#include "AmbiverseComposite.h"
+#include "AmbiverseElement.h"
+#include "AmbiverseLayer.h"
+#include "AmbiverseLayerManager.h"
+#include "AmbiverseParameter.h"
+#include "AmbiverseParameterManager.h"
+#include "AmbiverseSubsystem.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Validates the Ambiverse scheduler by simulating long stretches of layer time with a mocked clock and a seeded random stream.
+ *	Usage: UnrealEditor-Cmd <Project> -ExecCmds="Automation RunTests Ambiverse.Scheduler; Quit" -nullrhi -unattended */
+namespace AmbiverseSchedulerTests
+{
+	constexpr EAutomationTestFlags::Type TestFlags {EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter};
+
+	constexpr int32 Seed {1};
+	constexpr float SimulatedHours {2.0f};
+	constexpr float DeltaTime {1.0f / 60.0f};
+
+	/** A headless world with the Ambiverse subsystem in simulation mode and a registered parameter. The world is destroyed with the context. */
+	class FSchedulerTestContext
+	{
+	public:
+		UWorld* World {nullptr};
+		UAmbiverseSubsystem* Subsystem {nullptr};
+		UAmbiverseLayerManager* LayerManager {nullptr};
+		UAmbiverseParameter* Parameter {nullptr};
+
+		explicit FSchedulerTestContext(FAutomationTestBase& InTest)
+			: Test(InTest)
+		{
+			World = FAmbiverseCommandletUtils::CreateWorld(TEXT("AmbiverseSchedulerTest"));
+			Subsystem = World->GetSubsystem<UAmbiverseSubsystem>();
+			LayerManager = Subsystem ? Subsystem->GetLayerManager() : nullptr;
+
+			if (!LayerManager)
+			{
+				Test.AddError(TEXT("Unable to create the AmbiverseSubsystem."));
+				return;
+			}
+
+			Subsystem->SetSimulationMode(true);
+
+			UPackage* Package {GetTransientPackage()};
+			Parameter = NewObject<UAmbiverseParameter>(Package, MakeUniqueObjectName(Package, UAmbiverseParameter::StaticClass(), TEXT("SchedulerTestParameter")), RF_Transient);
+			if (UAmbiverseParameterManager* ParameterManager {Subsystem->GetParameterManager()})
+			{
+				ParameterManager->RegisterParameter(Parameter);
+				ParameterManager->SetParameterValue(Parameter, FMath::Lerp(Parameter->ParameterRange.X, Parameter->ParameterRange.Y, 0.25));
+			}
+		}
+
+		~FSchedulerTestContext()
+		{
+			FAmbiverseCommandletUtils::DestroyWorld(World);
+		}
+
+		bool IsValid() const { return LayerManager != nullptr; }
+
+		void Tick(const float TickDeltaTime) const
+		{
+			FAmbiverseCommandletUtils::TickSubsystem(Subsystem, TickDeltaTime);
+		}
+
+		void TickFor(const float Duration) const
+		{
+			for (float Time {0.0f}; Time < Duration; Time += DeltaTime)
+			{
+				Tick(DeltaTime);
+			}
+		}
+
+		UAmbiverseLayer* CreateLayer(const FString& Name, const int32 ElementCount, const FVector2D& IntervalRange, const float LayerDensity,
+			const FVector2D& DensityRange = FVector2D(1.0, 1.0)) const
+		{
+			UPackage* Package {GetTransientPackage()};
+			UAmbiverseLayer* Layer {NewObject<UAmbiverseLayer>(Package, MakeUniqueObjectName(Package, UAmbiverseLayer::StaticClass(), *Name), RF_Transient)};
+			Layer->LayerDensity = LayerDensity;
+
+			FAmbiverseParameterModifiers& Modifiers {Layer->Parameters.AddDefaulted_GetRef()};
+			Modifiers.Parameter = Parameter;
+			Modifiers.DensityRange = DensityRange;
+
+			for (int32 Index {0}; Index < ElementCount; ++Index)
+			{
+				FAmbiverseProceduralElement& ProceduralElement {Layer->ProceduralElements.AddDefaulted_GetRef()};
+				ProceduralElement.Element = NewObject<UAmbiverseElement>(Layer, *FString::Printf(TEXT("%s_%d"), *Name, Index), RF_Transient);
+				ProceduralElement.IntervalRange = IntervalRange;
+			}
+
+			return Layer;
+		}
+
+		UAmbiverseComposite* CreateComposite(const FString& Name, UAmbiverseLayer* Layer, const bool StopNonCompositeLayers) const
+		{
+			UPackage* Package {GetTransientPackage()};
+			UAmbiverseComposite* Composite {NewObject<UAmbiverseComposite>(Package, MakeUniqueObjectName(Package, UAmbiverseComposite::StaticClass(), *Name), RF_Transient)};
+			Composite->Layers.Add(Layer);
+			Composite->StopNonCompositeLayers = StopNonCompositeLayers;
+			Composite->CrossfadeDuration = 2.0f;
+
+			return Composite;
+		}
+
+		/** Registers a layer, ticks it for a duration and returns the scheduled onset times of its fired elements.
+		 *	If a hitch delta time is provided, a single tick of that length is made halfway through the duration. */
+		TArray<double> RecordOnsets(UAmbiverseLayer* Layer, const double Duration, const float TickDeltaTime, const float HitchDeltaTime = 0.0f) const
+		{
+			TArray<double> Onsets;
+
+			/** The mocked clock. Elements are advanced by the delta time before they fire, so an element that fires was due at the clock minus its lateness. */
+			double Clock {0.0};
+
+			const FDelegateHandle Handle {Subsystem->OnElementFired.AddLambda([Layer, &Onsets, &Clock](const UAmbiverseLayer* FiredLayer,
+				const FAmbiverseProceduralElement&, const float Lateness)
+			{
+				if (FiredLayer == Layer)
+				{
+					Onsets.Add(Clock - Lateness);
+				}
+			})};
+
+			Subsystem->SetRandomSeed(Seed);
+			LayerManager->RegisterAmbiverseLayer(Layer);
+
+			bool HasHitched {HitchDeltaTime <= 0.0f};
+			while (Clock < Duration)
+			{
+				float ClockDeltaTime {TickDeltaTime};
+				if (!HasHitched && Clock >= Duration * 0.5)
+				{
+					ClockDeltaTime = HitchDeltaTime;
+					HasHitched = true;
+				}
+
+				Clock += ClockDeltaTime;
+				Tick(ClockDeltaTime);
+			}
+
+			LayerManager->UnregisterAmbiverseLayer(Layer);
+			Subsystem->OnElementFired.Remove(Handle);
+
+			return Onsets;
+		}
+
+		/** Counts the elements of a layer that fire while ticking for a number of ticks. */
+		int32 CountFires(const UAmbiverseLayer* Layer, const int32 TickCount) const
+		{
+			int32 FireCount {0};
+			const FDelegateHandle Handle {Subsystem->OnElementFired.AddLambda([Layer, &FireCount](const UAmbiverseLayer* FiredLayer, const FAmbiverseProceduralElement&, float)
+			{
+				FireCount += FiredLayer == Layer ? 1 : 0;
+			})};
+
+			for (int32 TickIndex {0}; TickIndex < TickCount; ++TickIndex)
+			{
+				Tick(DeltaTime);
+			}
+
+			Subsystem->OnElementFired.Remove(Handle);
+			return FireCount;
+		}
+
+		/** Ticks for a number of ticks and returns whether every element of the layer kept a finite time. */
+		bool TickWithFiniteTimes(const UAmbiverseLayer* Layer, const int32 TickCount) const
+		{
+			bool IsFinite {true};
+			for (int32 TickIndex {0}; TickIndex < TickCount; ++TickIndex)
+			{
+				Tick(DeltaTime);
+
+				for (const FAmbiverseProceduralElement& ProceduralElement : Layer->ProceduralElements)
+				{
+					IsFinite &= FMath::IsFinite(ProceduralElement.Time) && FMath::IsFinite(ProceduralElement.ReferenceTime);
+				}
+			}
+			return IsFinite;
+		}
+
+		/** Checks that two runs fired the same events at the same times. The last event can fall on either side of the end of the run,
+		 *	due to the different rounding of the clocks. */
+		bool TestOnsetsMatch(const TArray<double>& Onsets, const TArray<double>& ReferenceOnsets) const
+		{
+			if (FMath::Abs(Onsets.Num() - ReferenceOnsets.Num()) > 1)
+			{
+				Test.AddError(FString::Printf(TEXT("%d events fired, expected %d."), Onsets.Num(), ReferenceOnsets.Num()));
+				return false;
+			}
+
+			for (int32 Index {0}; Index < FMath::Min(Onsets.Num(), ReferenceOnsets.Num()); ++Index)
+			{
+				if (!FMath::IsNearlyEqual(Onsets[Index], ReferenceOnsets[Index], 0.01))
+				{
+					Test.AddError(FString::Printf(TEXT("Onset %d at %f, expected %f."), Index, Onsets[Index], ReferenceOnsets[Index]));
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+	private:
+		FAutomationTestBase& Test;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseSchedulerIntervalDistributionTest, "Ambiverse.Scheduler.IntervalDistribution", AmbiverseSchedulerTests::TestFlags)
+
+/** Checks that the observed intervals between onsets follow the interval range, scaled by the layer density and parameter density range. */
+bool FAmbiverseSchedulerIntervalDistributionTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseSchedulerTests;
+
+	const FSchedulerTestContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	const FVector2D IntervalRange {2.0, 6.0};
+	const float LayerDensity {1.5f};
+	const FVector2D DensityRange {0.5, 2.0};
+
+	UAmbiverseLayer* Layer {Context.CreateLayer(TEXT("IntervalDistribution"), 1, IntervalRange, LayerDensity, DensityRange)};
+	const TArray<double> Onsets {Context.RecordOnsets(Layer, SimulatedHours * 3600.0, DeltaTime)};
+
+	if (Onsets.Num() < 100)
+	{
+		AddError(FString::Printf(TEXT("Only %d onsets were recorded."), Onsets.Num()));
+		return false;
+	}
+
+	/** The parameter manager multiplies the layer density with the mapped parameter density and uses its inverse as the interval scale. */
+	const double ParameterDensity {FMath::GetMappedRangeValueClamped(FVector2D(0.0, 1.0), DensityRange, Context.Parameter->ParameterValue)};
+	const double IntervalScale {1.0 / (LayerDensity * ParameterDensity)};
+	const double MinInterval {IntervalRange.X * IntervalScale};
+	const double MaxInterval {IntervalRange.Y * IntervalScale};
+
+	TArray<double> Intervals;
+	Intervals.Reserve(Onsets.Num() - 1);
+	for (int32 Index {1}; Index < Onsets.Num(); ++Index)
+	{
+		Intervals.Add(Onsets[Index] - Onsets[Index - 1]);
+	}
+	Intervals.Sort();
+
+	constexpr double Tolerance {1.0e-3};
+	TestTrue(FString::Printf(TEXT("Intervals [%f, %f] are within [%f, %f]"), Intervals[0], Intervals.Last(), MinInterval, MaxInterval),
+		Intervals[0] >= MinInterval - Tolerance && Intervals.Last() <= MaxInterval + Tolerance);
+
+	/** The mean of a uniform distribution, within four standard errors. */
+	double Sum {0.0};
+	for (const double Interval : Intervals) { Sum += Interval; }
+
+	const double Mean {Sum / Intervals.Num()};
+	const double ExpectedMean {(MinInterval + MaxInterval) * 0.5};
+	const double StandardError {(MaxInterval - MinInterval) / FMath::Sqrt(12.0 * Intervals.Num())};
+
+	TestTrue(FString::Printf(TEXT("Mean interval %f matches expected %f"), Mean, ExpectedMean), FMath::Abs(Mean - ExpectedMean) <= 4.0 * StandardError);
+
+	/** A Kolmogorov-Smirnov test against the uniform distribution, at a significance level of 1%. */
+	double MaxDeviation {0.0};
+	for (int32 Index {0}; Index < Intervals.Num(); ++Index)
+	{
+		const double Expected {FMath::Clamp((Intervals[Index] - MinInterval) / (MaxInterval - MinInterval), 0.0, 1.0)};
+		MaxDeviation = FMath::Max(MaxDeviation, FMath::Max(static_cast<double>(Index + 1) / Intervals.Num() - Expected,
+			Expected - static_cast<double>(Index) / Intervals.Num()));
+	}
+
+	const double CriticalDeviation {1.63 / FMath::Sqrt(static_cast<double>(Intervals.Num()))};
+	TestTrue(FString::Printf(TEXT("KS statistic %f is within %f"), MaxDeviation, CriticalDeviation), MaxDeviation <= CriticalDeviation);
+
+	AddInfo(FString::Printf(TEXT("%d intervals, mean %f (expected %f), KS %f."), Intervals.Num(), Mean, ExpectedMean, MaxDeviation));
+
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseSchedulerLargeDeltaTimeTest, "Ambiverse.Scheduler.LargeDeltaTime", AmbiverseSchedulerTests::TestFlags)
+
+/** Checks that ticking with a delta time longer than the interval fires the same events as ticking at a normal rate. */
+bool FAmbiverseSchedulerLargeDeltaTimeTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseSchedulerTests;
+
+	const FSchedulerTestContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	const FVector2D IntervalRange {0.5, 1.5};
+	constexpr float LargeDeltaTime {7.0f};
+	constexpr double Duration {LargeDeltaTime * 100.0};
+
+	/** Both runs use the same seed, so they draw the same intervals. */
+	UAmbiverseLayer* ReferenceLayer {Context.CreateLayer(TEXT("LargeDeltaTimeReference"), 1, IntervalRange, 1.0f)};
+	const TArray<double> ReferenceOnsets {Context.RecordOnsets(ReferenceLayer, Duration, DeltaTime)};
+
+	UAmbiverseLayer* Layer {Context.CreateLayer(TEXT("LargeDeltaTime"), 1, IntervalRange, 1.0f)};
+	const TArray<double> Onsets {Context.RecordOnsets(Layer, Duration, LargeDeltaTime)};
+
+	return Context.TestOnsetsMatch(Onsets, ReferenceOnsets);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseSchedulerHitchTest, "Ambiverse.Scheduler.Hitch", AmbiverseSchedulerTests::TestFlags)
+
+/** Checks that a hitch outside of simulation mode defers missed events beyond the fire limit instead of dropping them. */
+bool FAmbiverseSchedulerHitchTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseSchedulerTests;
+
+	const FSchedulerTestContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	const FVector2D IntervalRange {0.5, 1.5};
+	constexpr float HitchDeltaTime {10.0f};
+	constexpr double Duration {60.0};
+
+	/** Outside of simulation mode the number of fires per tick is limited, and sounds are requested for a listener. */
+	FAmbiverseCommandletUtils::SpawnListener(Context.World, Context.Subsystem);
+	Context.Subsystem->SetSimulationMode(false);
+
+	UAmbiverseLayer* ReferenceLayer {Context.CreateLayer(TEXT("HitchReference"), 1, IntervalRange, 1.0f)};
+	const TArray<double> ReferenceOnsets {Context.RecordOnsets(ReferenceLayer, Duration, DeltaTime)};
+
+	UAmbiverseLayer* Layer {Context.CreateLayer(TEXT("Hitch"), 1, IntervalRange, 1.0f)};
+	const TArray<double> Onsets {Context.RecordOnsets(Layer, Duration, DeltaTime, HitchDeltaTime)};
+
+	return Context.TestOnsetsMatch(Onsets, ReferenceOnsets);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseSchedulerZeroDensityTest, "Ambiverse.Scheduler.ZeroDensity", AmbiverseSchedulerTests::TestFlags)
+
+/** Checks that elements with a density of zero keep finite times, and fire again once the density is raised. */
+bool FAmbiverseSchedulerZeroDensityTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseSchedulerTests;
+
+	const FSchedulerTestContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	UAmbiverseLayer* Layer {Context.CreateLayer(TEXT("ZeroDensity"), 4, FVector2D(0.5, 1.0), 0.0f)};
+	Context.LayerManager->RegisterAmbiverseLayer(Layer);
+
+	TestTrue(TEXT("Elements keep finite times at zero density"), Context.TickWithFiniteTimes(Layer, 600));
+
+	/** Raising the density rescales the remaining time, so the elements fire within their interval again. */
+	Layer->LayerDensity = 1.0f;
+	for (int32 ElementIndex {0}; ElementIndex < Layer->ProceduralElements.Num(); ++ElementIndex)
+	{
+		FAmbiverseProceduralElement& ProceduralElement {Layer->ProceduralElements[ElementIndex]};
+		ProceduralElement.Time = ProceduralElement.ReferenceTime * Context.Subsystem->GetDensityModifier(Layer, ElementIndex);
+	}
+
+	TestTrue(TEXT("Events fire after the density is raised"), Context.CountFires(Layer, 600) > 0);
+
+	Context.LayerManager->UnregisterAmbiverseLayer(Layer);
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseSchedulerWarmUpTest, "Ambiverse.Scheduler.WarmUp", AmbiverseSchedulerTests::TestFlags)
+
+/** Checks that registering a layer gives every element a finite time within its interval. */
+bool FAmbiverseSchedulerWarmUpTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseSchedulerTests;
+
+	const FSchedulerTestContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	const FVector2D IntervalRange {1.0, 4.0};
+	UAmbiverseLayer* Layer {Context.CreateLayer(TEXT("WarmUp"), 32, IntervalRange, 1.0f)};
+
+	Context.Subsystem->SetRandomSeed(Seed);
+	Context.LayerManager->RegisterAmbiverseLayer(Layer);
+
+	for (const FAmbiverseProceduralElement& ProceduralElement : Layer->ProceduralElements)
+	{
+		if (!FMath::IsFinite(ProceduralElement.Time) || !FMath::IsFinite(ProceduralElement.ReferenceTime)
+			|| ProceduralElement.Time < 0.0f || ProceduralElement.Time > IntervalRange.Y + UE_KINDA_SMALL_NUMBER)
+		{
+			AddError(FString::Printf(TEXT("Element has time %f and reference time %f."), ProceduralElement.Time, ProceduralElement.ReferenceTime));
+		}
+	}
+
+	Context.LayerManager->UnregisterAmbiverseLayer(Layer);
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseSchedulerRegistrationTest, "Ambiverse.Scheduler.Registration", AmbiverseSchedulerTests::TestFlags)
+
+/** Checks that layers are registered once, empty layers are rejected and unregistered layers no longer fire. */
+bool FAmbiverseSchedulerRegistrationTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseSchedulerTests;
+
+	const FSchedulerTestContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	UAmbiverseLayerManager* LayerManager {Context.LayerManager};
+	const int32 InitialLayerCount {LayerManager->GetActiveLayerCount()};
+
+	UAmbiverseLayer* Layer {Context.CreateLayer(TEXT("Registration"), 4, FVector2D(0.5, 1.0), 1.0f)};
+	LayerManager->RegisterAmbiverseLayer(Layer);
+	LayerManager->RegisterAmbiverseLayer(Layer);
+
+	TestEqual(TEXT("Layers added by registering a layer twice"), LayerManager->GetActiveLayerCount() - InitialLayerCount, 1);
+
+	UAmbiverseLayer* EmptyLayer {Context.CreateLayer(TEXT("RegistrationEmpty"), 0, FVector2D(0.5, 1.0), 1.0f)};
+	LayerManager->RegisterAmbiverseLayer(EmptyLayer);
+
+	TestNull(TEXT("A layer without elements is registered"), LayerManager->FindActiveAmbienceLayer(EmptyLayer));
+
+	LayerManager->UnregisterAmbiverseLayer(Layer);
+
+	TestEqual(TEXT("Active layers after unregistering"), LayerManager->GetActiveLayerCount(), InitialLayerCount);
+	TestEqual(TEXT("Fires of an unregistered layer"), Context.CountFires(Layer, 600), 0);
+
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseSchedulerFiniteTimesTest, "Ambiverse.Scheduler.FiniteTimes", AmbiverseSchedulerTests::TestFlags)
+
+/** Checks that elements that reach exactly zero remaining time keep finite times. */
+bool FAmbiverseSchedulerFiniteTimesTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseSchedulerTests;
+
+	const FSchedulerTestContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	UAmbiverseLayer* Layer {Context.CreateLayer(TEXT("FiniteTimes"), 4, FVector2D(0.5, 1.0), 1.0f)};
+	Context.LayerManager->RegisterAmbiverseLayer(Layer);
+
+	/** An element that reaches exactly zero used to divide by its remaining time. */
+	for (FAmbiverseProceduralElement& ProceduralElement : Layer->ProceduralElements)
+	{
+		ProceduralElement.Time = 0.0f;
+		ProceduralElement.ReferenceTime = 1.0f;
+	}
+
+	TestTrue(TEXT("Elements keep finite times"), Context.TickWithFiniteTimes(Layer, 600));
+
+	Context.LayerManager->UnregisterAmbiverseLayer(Layer);
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAmbiverseSchedulerCompositeStackTest, "Ambiverse.Scheduler.CompositeStack", AmbiverseSchedulerTests::TestFlags)
+
+/** Checks that a layer stopped by a composite keeps fading out when another composite is pushed on top of it during the crossfade. */
+bool FAmbiverseSchedulerCompositeStackTest::RunTest(const FString& Parameters)
+{
+	using namespace AmbiverseSchedulerTests;
+
+	const FSchedulerTestContext Context {*this};
+	if (!Context.IsValid()) { return false; }
+
+	UAmbiverseLayerManager* LayerManager {Context.LayerManager};
+
+	UAmbiverseLayer* LayerA {Context.CreateLayer(TEXT("CompositeStackA"), 1, FVector2D(0.5, 1.0), 1.0f)};
+	UAmbiverseLayer* LayerB {Context.CreateLayer(TEXT("CompositeStackB"), 1, FVector2D(0.5, 1.0), 1.0f)};
+	UAmbiverseLayer* LayerC {Context.CreateLayer(TEXT("CompositeStackC"), 1, FVector2D(0.5, 1.0), 1.0f)};
+
+	UAmbiverseComposite* CompositeA {Context.CreateComposite(TEXT("CompositeStackA"), LayerA, false)};
+	UAmbiverseComposite* CompositeB {Context.CreateComposite(TEXT("CompositeStackB"), LayerB, true)};
+	UAmbiverseComposite* CompositeC {Context.CreateComposite(TEXT("CompositeStackC"), LayerC, false)};
+
+	LayerManager->PushComposite(CompositeA);
+	Context.TickFor(CompositeA->CrossfadeDuration + 0.5f);
+
+	/** Layer A starts fading out when B stops it, and must keep fading out when C is added on top of B. */
+	LayerManager->PushComposite(CompositeB);
+	Context.TickFor(CompositeB->CrossfadeDuration * 0.25f);
+	const float FadeBeforePush {LayerA->TransitionFade};
+
+	LayerManager->PushComposite(CompositeC);
+	Context.TickFor(CompositeC->CrossfadeDuration * 0.25f);
+
+	TestTrue(FString::Printf(TEXT("Layer A keeps fading out after pushing C (%f to %f)"), FadeBeforePush, LayerA->TransitionFade),
+		!LayerManager->FindActiveAmbienceLayer(LayerA) || LayerA->TransitionFade < FadeBeforePush);
+
+	Context.TickFor(CompositeB->CrossfadeDuration);
+
+	TestNull(TEXT("Layer A is active after its fade out"), LayerManager->FindActiveAmbienceLayer(LayerA));
+	TestNotNull(TEXT("Layer B is active"), LayerManager->FindActiveAmbienceLayer(LayerB));
+	TestNotNull(TEXT("Layer C is active"), LayerManager->FindActiveAmbienceLayer(LayerC));
+
+	while (!LayerManager->GetCompositeStack().IsEmpty())
+	{
+		LayerManager->PopComposite();
+	}
+
+	Context.TickFor(CompositeA->CrossfadeDuration + 0.5f);
+
+	for (UAmbiverseLayer* Layer : {LayerA, LayerB, LayerC})
+	{
+		LayerManager->UnregisterAmbiverseLayer(Layer);
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif
@@ -0,0 +1,32 @@
+// Copyright (c) 2022-present Tim Verberne
+// This source code is part of the Adaptive Ambience System plugin.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AmbiverseBudgetCommandlet.generated.h"
+
+struct FAmbiverseBudgetEstimate;
+
+/** Estimates the worst-case cost of every Ambiverse composite, layer and element in the project and writes a CSV report.
+ *	Composites are checked against their budget. Returns a non-zero exit code if any composite is over budget.
+ *	Usage: UnrealEditor-Cmd <Project> -run=AmbiverseBudget -nullrhi -unattended [-Output=<Path>] */
+UCLASS()
+class AMBIVERSEEDITOR_API UAmbiverseBudgetCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+	DECLARE_LOG_CATEGORY_CLASS(LogAmbiverseBudgetCommandlet, Log, All)
+
+public:
+	UAmbiverseBudgetCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/** Loads all assets of a class through the asset registry. */
+	static TArray<UObject*> LoadAssetsOfClass(const UClass* Class);
+
+	static FString FormatRow(const TCHAR* Type, const UObject* Asset, const FAmbiverseBudgetEstimate& Estimate, const TArray<FText>& ExceededBudgets);
+};
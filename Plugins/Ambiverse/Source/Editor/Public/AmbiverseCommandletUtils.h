@@ -0,0 +1,24 @@
+// Copyright (c) 2022-present Tim Verberne
+// This source code is part of the Adaptive Ambience System plugin.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UAmbiverseSubsystem;
+
+/** Helpers shared by the Ambiverse commandlets and automation tests, which run the runtime in a headless world. */
+class AMBIVERSEEDITOR_API FAmbiverseCommandletUtils
+{
+public:
+	/** Creates a game world that has begun play. The world has no player controllers. */
+	static UWorld* CreateWorld(const TCHAR* Name);
+	
+	static void DestroyWorld(UWorld* World);
+
+	/** Spawns an actor and registers it as a listener, as headless worlds have no player controllers. */
+	static AActor* SpawnListener(UWorld* World, UAmbiverseSubsystem* Subsystem);
+
+	/** Ticks only the Ambiverse subsystem. This allows the subsystem to be driven by a mocked clock. */
+	static void TickSubsystem(UAmbiverseSubsystem* Subsystem, const float DeltaTime);
+};
@@ -0,0 +1,77 @@
+// Copyright (c) 2022-present Tim Verberne
+// This source code is part of the Adaptive Ambience System plugin.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AmbiverseSimulateCommandlet.generated.h"
+
+class UAmbiverseLayer;
+class UAmbiverseParameterManager;
+
+/** Runs the Ambiverse scheduler offline at an accelerated time step and exports the event timeline and voice concurrency.
+ *	No world is rendered and no sounds are played, so a long route can be evaluated in seconds.
+ *	Usage: UnrealEditor-Cmd <Project> -run=AmbiverseSimulate -nullrhi -unattended -Assets=<Path>[+<Path>...] [-Parameters=<Path>:<Value>[+...]]
+ *	[-Duration=7200] [-DeltaTime=1] [-ListenerSpeed=500] [-VoiceDuration=5] [-Seed=1] [-Format=Json|Csv] [-Output=<Path>]
+ *	Assets can be composites or layers. */
+UCLASS()
+class AMBIVERSEEDITOR_API UAmbiverseSimulateCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+	DECLARE_LOG_CATEGORY_CLASS(LogAmbiverseSimulateCommandlet, Log, All)
+
+	struct FSettings
+	{
+		TArray<FString> AssetPaths;
+		TArray<TPair<FString, float>> ParameterValues;
+		double Duration {7200.0};
+		float DeltaTime {1.0f};
+		float ListenerSpeed {500.0f};
+
+		/** The lifetime of a voice whose sound has no finite duration, such as most MetaSounds. */
+		float VoiceDuration {5.0f};
+		
+		int32 Seed {1};
+		bool IsCsv {false};
+		FString OutputPath;
+	};
+
+	/** A single fired procedural element. */
+	struct FEvent
+	{
+		double Time {0.0};
+		double Duration {0.0};
+		FString Layer;
+		FString Element;
+		FString Variant;
+		FVector Location {FVector::ZeroVector};
+	};
+
+	/** The time spent at every number of concurrent voices. */
+	struct FConcurrency
+	{
+		TArray<double> SecondsPerVoiceCount;
+		int32 PeakVoiceCount {0};
+	};
+
+public:
+	UAmbiverseSimulateCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	static FSettings ParseSettings(const FString& Params);
+
+	/** Loads the layers of all composites and layers in the settings. */
+	static TArray<UAmbiverseLayer*> LoadLayers(const FSettings& Settings);
+
+	static void ApplyParameterValues(const FSettings& Settings, UAmbiverseParameterManager* ParameterManager);
+
+	/** Returns the concurrency of all events, or of the events of a single layer if a layer name is provided. */
+	static FConcurrency GetConcurrency(const TArray<FEvent>& Events, const double Duration, const FString* Layer = nullptr);
+
+	static bool WriteJson(const FSettings& Settings, const TArray<FEvent>& Events, const TMap<FString, FConcurrency>& Concurrency);
+	static bool WriteCsv(const FSettings& Settings, const TArray<FEvent>& Events, const TMap<FString, FConcurrency>& Concurrency);
+};
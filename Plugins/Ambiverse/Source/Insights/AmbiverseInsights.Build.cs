@@ -0,0 +1,33 @@
+// Some copyright should be here...
+
+using UnrealBuildTool;
+
+public class AmbiverseInsights : ModuleRules
+{
+	public AmbiverseInsights(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+		
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"TraceAnalysis",
+				"TraceServices",
+			}
+			);
+			
+		
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Slate",
+				"SlateCore",
+				"TraceInsights",
+			}
+			);
+		
+		/** Only the trace event definitions are shared with the runtime module, so it does not need to be linked. */
+		PrivateIncludePathModuleNames.AddRange(new string[] { "Ambiverse" });
+	}
+}
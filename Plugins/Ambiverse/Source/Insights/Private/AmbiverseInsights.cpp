@@ -0,0 +1,20 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseInsights.h"
+#include "Features/IModularFeatures.h"
+#include "Insights/ITimingViewExtender.h"
+#include "TraceServices/ModuleService.h"
+
+void FAmbiverseInsightsModule::StartupModule()
+{
+	IModularFeatures::Get().RegisterModularFeature(TraceServices::ModuleFeatureName, &TraceModule);
+	IModularFeatures::Get().RegisterModularFeature(Insights::TimingViewExtenderFeatureName, &TimingViewExtender);
+}
+
+void FAmbiverseInsightsModule::ShutdownModule()
+{
+	IModularFeatures::Get().UnregisterModularFeature(TraceServices::ModuleFeatureName, &TraceModule);
+	IModularFeatures::Get().UnregisterModularFeature(Insights::TimingViewExtenderFeatureName, &TimingViewExtender);
+}
+
+IMPLEMENT_MODULE(FAmbiverseInsightsModule, AmbiverseInsights)
@@ -0,0 +1,177 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseTimingTrack.h"
+#include "AmbiverseTrace.h"
+#include "AmbiverseTraceProvider.h"
+#include "Insights/Common/TimeUtils.h"
+#include "Insights/ViewModels/ITimingViewDrawHelper.h"
+#include "Insights/ViewModels/TimingEvent.h"
+#include "Insights/ViewModels/TimingTrackViewport.h"
+#include "Insights/ViewModels/TooltipDrawState.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+INSIGHTS_IMPLEMENT_RTTI(FAmbiverseTimingTrack)
+
+namespace AmbiverseTimingTrack
+{
+	/** The minimum width of an event, in seconds. */
+	constexpr double MinEventDuration {0.0005};
+	
+	constexpr uint32 LaneCount {3};
+}
+
+FAmbiverseTimingTrack::FAmbiverseTimingTrack(const TraceServices::IAnalysisSession& InAnalysisSession)
+	: FTimingEventsTrack(TEXT("Ambiverse"))
+	, AnalysisSession(InAnalysisSession)
+{
+	SetNumLanes(AmbiverseTimingTrack::LaneCount);
+}
+
+void FAmbiverseTimingTrack::BuildDrawState(ITimingEventsTrackDrawStateBuilder& Builder, const ITimingTrackUpdateContext& Context)
+{
+	TraceServices::FAnalysisSessionReadScope ReadScope(AnalysisSession);
+	
+	const FAmbiverseTraceProvider* Provider {AnalysisSession.ReadProvider<FAmbiverseTraceProvider>(FAmbiverseTraceProvider::ProviderName)};
+	if (!Provider) { return; }
+
+	const FTimingTrackViewport& Viewport {Context.GetViewport()};
+
+	/** Events are drawn from before their trace time, so events slightly past the end of the viewport can still be visible. */
+	Provider->EnumerateEvents(Viewport.GetStartTime(), Viewport.GetEndTime() + 1.0, [this, &Builder, Provider](const FAmbiverseTraceEvent& Event)
+	{
+		double StartTime {0.0};
+		double EndTime {0.0};
+		GetEventRange(Event, StartTime, EndTime);
+		
+		Builder.AddEvent(StartTime, EndTime, GetEventDepth(Event), Provider->GetName(Event.NameId), 0, GetEventColor(Event));
+	});
+}
+
+void FAmbiverseTimingTrack::InitTooltip(FTooltipDrawState& InOutTooltip, const ITimingEvent& InTooltipEvent) const
+{
+	if (!InTooltipEvent.CheckTrack(this) || !InTooltipEvent.Is<FTimingEvent>()) { return; }
+
+	const FTimingEvent& TimingEvent {InTooltipEvent.As<FTimingEvent>()};
+	
+	FAmbiverseTraceEvent Event;
+	if (!FindEvent(TimingEvent.GetStartTime(), TimingEvent.GetEndTime(), TimingEvent.GetDepth(), Event)) { return; }
+
+	TraceServices::FAnalysisSessionReadScope ReadScope(AnalysisSession);
+	
+	const FAmbiverseTraceProvider* Provider {AnalysisSession.ReadProvider<FAmbiverseTraceProvider>(FAmbiverseTraceProvider::ProviderName)};
+	if (!Provider) { return; }
+
+	InOutTooltip.ResetContent();
+	InOutTooltip.AddTitle(Provider->GetName(Event.NameId));
+
+	switch (Event.Type)
+	{
+	case EAmbiverseTraceEventType::ElementFired:
+		InOutTooltip.AddNameValueTextLine(TEXT("Layer:"), Provider->GetName(Event.LayerId));
+		InOutTooltip.AddNameValueTextLine(TEXT("Sound:"), Provider->GetName(Event.SoundId));
+		InOutTooltip.AddNameValueTextLine(TEXT("Location:"), FString::Printf(TEXT("%.0f, %.0f, %.0f"), Event.Location.X, Event.Location.Y, Event.Location.Z));
+		InOutTooltip.AddNameValueTextLine(TEXT("Deferral:"), TimeUtils::FormatTimeAuto(Event.Value));
+		break;
+		
+	case EAmbiverseTraceEventType::VoiceRequest:
+		{
+			static const TCHAR* ResultNames[] {TEXT("Pooled"), TEXT("Spawned"), TEXT("Dropped")};
+			InOutTooltip.AddNameValueTextLine(TEXT("Voice:"), Event.VoiceResult < UE_ARRAY_COUNT(ResultNames) ? ResultNames[Event.VoiceResult] : TEXT("Unknown"));
+		}
+		break;
+		
+	case EAmbiverseTraceEventType::ParameterChanged:
+		InOutTooltip.AddNameValueTextLine(TEXT("Value:"), FString::Printf(TEXT("%.3f"), Event.Value));
+		break;
+	}
+
+	InOutTooltip.UpdateLayout();
+}
+
+const TSharedPtr<const ITimingEvent> FAmbiverseTimingTrack::SearchEvent(const FTimingEventSearchParameters& InSearchParameters) const
+{
+	TraceServices::FAnalysisSessionReadScope ReadScope(AnalysisSession);
+	
+	const FAmbiverseTraceProvider* Provider {AnalysisSession.ReadProvider<FAmbiverseTraceProvider>(FAmbiverseTraceProvider::ProviderName)};
+	if (!Provider) { return nullptr; }
+
+	TSharedPtr<const ITimingEvent> FoundEvent;
+	
+	Provider->EnumerateEvents(InSearchParameters.StartTime, InSearchParameters.EndTime + 1.0, [this, &InSearchParameters, &FoundEvent](const FAmbiverseTraceEvent& Event)
+	{
+		if (FoundEvent.IsValid()) { return; }
+		
+		double StartTime {0.0};
+		double EndTime {0.0};
+		GetEventRange(Event, StartTime, EndTime);
+
+		if (StartTime <= InSearchParameters.EndTime && EndTime >= InSearchParameters.StartTime)
+		{
+			FoundEvent = MakeShared<FTimingEvent>(SharedThis(this), StartTime, EndTime, GetEventDepth(Event));
+		}
+	});
+
+	return FoundEvent;
+}
+
+void FAmbiverseTimingTrack::GetEventRange(const FAmbiverseTraceEvent& Event, double& OutStartTime, double& OutEndTime)
+{
+	/** Fired elements are drawn from the time they were due, voice requests and parameter changes are instantaneous. */
+	const double Latency {Event.Type == EAmbiverseTraceEventType::ElementFired ? FMath::Max(0.0, static_cast<double>(Event.Value)) : 0.0};
+	
+	OutStartTime = Event.Time - Latency;
+	OutEndTime = FMath::Max(Event.Time, OutStartTime + AmbiverseTimingTrack::MinEventDuration);
+}
+
+uint32 FAmbiverseTimingTrack::GetEventDepth(const FAmbiverseTraceEvent& Event)
+{
+	return static_cast<uint32>(Event.Type);
+}
+
+uint32 FAmbiverseTimingTrack::GetEventColor(const FAmbiverseTraceEvent& Event)
+{
+	switch (Event.Type)
+	{
+	case EAmbiverseTraceEventType::ElementFired:
+		return 0xFF3C8DBC;
+	case EAmbiverseTraceEventType::VoiceRequest:
+		switch (static_cast<EAmbiverseTraceVoiceResult>(Event.VoiceResult))
+		{
+		case EAmbiverseTraceVoiceResult::Pooled:
+			return 0xFF4CAF50;
+		case EAmbiverseTraceVoiceResult::Spawned:
+			return 0xFFFFA000;
+		default:
+			return 0xFFD32F2F;
+		}
+	default:
+		return 0xFF9575CD;
+	}
+}
+
+bool FAmbiverseTimingTrack::FindEvent(const double StartTime, const double EndTime, const uint32 Depth, FAmbiverseTraceEvent& OutEvent) const
+{
+	TraceServices::FAnalysisSessionReadScope ReadScope(AnalysisSession);
+	
+	const FAmbiverseTraceProvider* Provider {AnalysisSession.ReadProvider<FAmbiverseTraceProvider>(FAmbiverseTraceProvider::ProviderName)};
+	if (!Provider) { return false; }
+
+	bool IsFound {false};
+	
+	Provider->EnumerateEvents(StartTime, EndTime + 1.0, [&](const FAmbiverseTraceEvent& Event)
+	{
+		if (IsFound || GetEventDepth(Event) != Depth) { return; }
+		
+		double EventStartTime {0.0};
+		double EventEndTime {0.0};
+		GetEventRange(Event, EventStartTime, EventEndTime);
+
+		if (FMath::IsNearlyEqual(EventStartTime, StartTime) && FMath::IsNearlyEqual(EventEndTime, EndTime))
+		{
+			OutEvent = Event;
+			IsFound = true;
+		}
+	});
+
+	return IsFound;
+}
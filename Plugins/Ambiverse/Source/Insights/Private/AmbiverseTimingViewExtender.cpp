@@ -0,0 +1,69 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseTimingViewExtender.h"
+#include "AmbiverseTimingTrack.h"
+#include "AmbiverseTraceProvider.h"
+#include "Framework/MultiBox/MultiBoxBuilder.h"
+#include "Insights/ITimingViewSession.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+#define LOCTEXT_NAMESPACE "AmbiverseTimingViewExtender"
+
+void FAmbiverseTimingViewExtender::OnBeginSession(Insights::ITimingViewSession& InSession)
+{
+	PerSessionDataMap.Add(&InSession, FPerSessionData());
+}
+
+void FAmbiverseTimingViewExtender::OnEndSession(Insights::ITimingViewSession& InSession)
+{
+	PerSessionDataMap.Remove(&InSession);
+}
+
+void FAmbiverseTimingViewExtender::Tick(Insights::ITimingViewSession& InSession, const TraceServices::IAnalysisSession& InAnalysisSession)
+{
+	FPerSessionData* PerSessionData {PerSessionDataMap.Find(&InSession)};
+	if (!PerSessionData || PerSessionData->Track.IsValid()) { return; }
+
+	/** The track is only added once the session contains Ambiverse events, so sessions without them are not cluttered. */
+	TraceServices::FAnalysisSessionReadScope ReadScope(InAnalysisSession);
+	
+	const FAmbiverseTraceProvider* Provider {InAnalysisSession.ReadProvider<FAmbiverseTraceProvider>(FAmbiverseTraceProvider::ProviderName)};
+	if (!Provider || Provider->GetEventCount() == 0) { return; }
+
+	PerSessionData->Track = MakeShared<FAmbiverseTimingTrack>(InAnalysisSession);
+	PerSessionData->Track->SetVisibilityFlag(IsTrackVisible);
+	InSession.AddScrollableTrack(PerSessionData->Track);
+}
+
+void FAmbiverseTimingViewExtender::ExtendFilterMenu(Insights::ITimingViewSession& InSession, FMenuBuilder& InMenuBuilder)
+{
+	InMenuBuilder.BeginSection("Ambiverse", LOCTEXT("AmbiverseHeader", "Ambiverse"));
+	
+	InMenuBuilder.AddMenuEntry(
+		LOCTEXT("ShowAmbiverseTrack", "Ambiverse Events"),
+		LOCTEXT("ShowAmbiverseTrackTooltip", "Show or hide the track with fired elements, voice requests and parameter changes."),
+		FSlateIcon(),
+		FUIAction(
+			FExecuteAction::CreateRaw(this, &FAmbiverseTimingViewExtender::ToggleTrackVisibility),
+			FCanExecuteAction(),
+			FIsActionChecked::CreateLambda([this]() { return IsTrackVisible; })),
+		NAME_None,
+		EUserInterfaceActionType::ToggleButton);
+	
+	InMenuBuilder.EndSection();
+}
+
+void FAmbiverseTimingViewExtender::ToggleTrackVisibility()
+{
+	IsTrackVisible = !IsTrackVisible;
+
+	for (TPair<Insights::ITimingViewSession*, FPerSessionData>& Pair : PerSessionDataMap)
+	{
+		if (Pair.Value.Track.IsValid())
+		{
+			Pair.Value.Track->SetVisibilityFlag(IsTrackVisible);
+		}
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
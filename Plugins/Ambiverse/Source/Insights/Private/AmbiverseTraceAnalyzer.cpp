@@ -0,0 +1,71 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseTraceAnalyzer.h"
+#include "AmbiverseTraceProvider.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+FAmbiverseTraceAnalyzer::FAmbiverseTraceAnalyzer(TraceServices::IAnalysisSession& InSession, FAmbiverseTraceProvider& InProvider)
+	: Session(InSession)
+	, Provider(InProvider)
+{
+}
+
+void FAmbiverseTraceAnalyzer::OnAnalysisBegin(const FOnAnalysisContext& Context)
+{
+	FInterfaceBuilder& Builder {Context.InterfaceBuilder};
+
+	Builder.RouteEvent(RouteId_Name, "Ambiverse", "Name");
+	Builder.RouteEvent(RouteId_ElementFired, "Ambiverse", "ElementFired");
+	Builder.RouteEvent(RouteId_VoiceRequest, "Ambiverse", "VoiceRequest");
+	Builder.RouteEvent(RouteId_ParameterChanged, "Ambiverse", "ParameterChanged");
+}
+
+bool FAmbiverseTraceAnalyzer::OnEvent(uint16 RouteId, EStyle Style, const FOnEventContext& Context)
+{
+	TraceServices::FAnalysisSessionEditScope EditScope(Session);
+
+	const FEventData& EventData {Context.EventData};
+
+	if (RouteId == RouteId_Name)
+	{
+		FString Name;
+		EventData.GetString("Name", Name);
+		Provider.AppendName(EventData.GetValue<uint64>("Id"), *Name);
+		return true;
+	}
+
+	FAmbiverseTraceEvent Event;
+	Event.Time = Context.EventTime.AsSeconds(EventData.GetValue<uint64>("Cycle"));
+
+	switch (RouteId)
+	{
+	case RouteId_ElementFired:
+		Event.Type = EAmbiverseTraceEventType::ElementFired;
+		Event.NameId = EventData.GetValue<uint64>("ElementId");
+		Event.LayerId = EventData.GetValue<uint64>("LayerId");
+		Event.SoundId = EventData.GetValue<uint64>("SoundId");
+		Event.Location = FVector3f(EventData.GetValue<float>("X"), EventData.GetValue<float>("Y"), EventData.GetValue<float>("Z"));
+		Event.Value = EventData.GetValue<float>("DeferralLatency");
+		break;
+		
+	case RouteId_VoiceRequest:
+		Event.Type = EAmbiverseTraceEventType::VoiceRequest;
+		Event.NameId = EventData.GetValue<uint64>("ElementId");
+		Event.VoiceResult = EventData.GetValue<uint8>("Result");
+		break;
+		
+	case RouteId_ParameterChanged:
+		Event.Type = EAmbiverseTraceEventType::ParameterChanged;
+		Event.NameId = EventData.GetValue<uint64>("ParameterId");
+		Event.Value = EventData.GetValue<float>("Value");
+		break;
+		
+	default:
+		return true;
+	}
+
+	Provider.AppendEvent(Event);
+	Session.UpdateDurationSeconds(Event.Time);
+	
+	return true;
+}
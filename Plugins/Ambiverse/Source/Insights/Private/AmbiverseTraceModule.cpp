@@ -0,0 +1,25 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseTraceModule.h"
+#include "AmbiverseTraceAnalyzer.h"
+#include "AmbiverseTraceProvider.h"
+
+FName FAmbiverseTraceModule::ModuleName("AmbiverseTrace");
+
+void FAmbiverseTraceModule::GetModuleInfo(TraceServices::FModuleInfo& OutModuleInfo)
+{
+	OutModuleInfo.Name = ModuleName;
+	OutModuleInfo.DisplayName = TEXT("Ambiverse");
+}
+
+void FAmbiverseTraceModule::OnAnalysisBegin(TraceServices::IAnalysisSession& InSession)
+{
+	const TSharedPtr<FAmbiverseTraceProvider> Provider {MakeShared<FAmbiverseTraceProvider>(InSession)};
+	InSession.AddProvider(FAmbiverseTraceProvider::ProviderName, Provider);
+	InSession.AddAnalyzer(new FAmbiverseTraceAnalyzer(InSession, *Provider));
+}
+
+void FAmbiverseTraceModule::GetLoggers(TArray<const TCHAR*>& OutLoggers)
+{
+	OutLoggers.Add(TEXT("Ambiverse"));
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseTraceProvider.h"
+#include "Algo/BinarySearch.h"
+
+FName FAmbiverseTraceProvider::ProviderName("AmbiverseTraceProvider");
+
+FAmbiverseTraceProvider::FAmbiverseTraceProvider(TraceServices::IAnalysisSession& InSession)
+	: Session(InSession)
+{
+}
+
+void FAmbiverseTraceProvider::AppendName(const uint64 Id, const TCHAR* Name)
+{
+	Session.WriteAccessCheck();
+	
+	Names.Add(Id, Session.StoreString(Name));
+}
+
+void FAmbiverseTraceProvider::AppendEvent(const FAmbiverseTraceEvent& Event)
+{
+	Session.WriteAccessCheck();
+
+	/** Events are traced from the game thread, so they arrive in order. */
+	Events.Add(Event);
+}
+
+const TCHAR* FAmbiverseTraceProvider::GetName(const uint64 Id) const
+{
+	const TCHAR* const* Name {Names.Find(Id)};
+	return Name ? *Name : TEXT("");
+}
+
+void FAmbiverseTraceProvider::EnumerateEvents(const double StartTime, const double EndTime, TFunctionRef<void(const FAmbiverseTraceEvent&)> Callback) const
+{
+	Session.ReadAccessCheck();
+
+	const int32 FirstIndex {Algo::LowerBoundBy(Events, StartTime, [](const FAmbiverseTraceEvent& Event) { return Event.Time; })};
+	
+	for (int32 Index {FirstIndex}; Index < Events.Num() && Events[Index].Time <= EndTime; ++Index)
+	{
+		Callback(Events[Index]);
+	}
+}
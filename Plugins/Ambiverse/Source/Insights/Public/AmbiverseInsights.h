@@ -0,0 +1,20 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AmbiverseTimingViewExtender.h"
+#include "AmbiverseTraceModule.h"
+#include "Modules/ModuleManager.h"
+
+/** Adds analysis of the AmbiverseChannel trace channel and an Ambiverse track to the timing view of Unreal Insights. */
+class FAmbiverseInsightsModule : public IModuleInterface
+{
+public:
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+
+private:
+	FAmbiverseTraceModule TraceModule;
+	FAmbiverseTimingViewExtender TimingViewExtender;
+};
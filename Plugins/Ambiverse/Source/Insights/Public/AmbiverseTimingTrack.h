@@ -0,0 +1,36 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Insights/ViewModels/TimingEventsTrack.h"
+
+struct FAmbiverseTraceEvent;
+
+namespace TraceServices { class IAnalysisSession; }
+
+/** A timing track with one lane for fired elements, one for voice requests and one for parameter changes.
+ *	Events are drawn from the time they were due until the time they were handled, so deferral shows up as width. */
+class FAmbiverseTimingTrack : public FTimingEventsTrack
+{
+	INSIGHTS_DECLARE_RTTI(FAmbiverseTimingTrack, FTimingEventsTrack)
+
+	const TraceServices::IAnalysisSession& AnalysisSession;
+
+public:
+	explicit FAmbiverseTimingTrack(const TraceServices::IAnalysisSession& InAnalysisSession);
+
+	virtual void BuildDrawState(ITimingEventsTrackDrawStateBuilder& Builder, const ITimingTrackUpdateContext& Context) override;
+	virtual void InitTooltip(FTooltipDrawState& InOutTooltip, const ITimingEvent& InTooltipEvent) const override;
+	virtual const TSharedPtr<const ITimingEvent> SearchEvent(const FTimingEventSearchParameters& InSearchParameters) const override;
+
+private:
+	/** Returns the range an event is drawn at. Events are at least wide enough to be visible. */
+	static void GetEventRange(const FAmbiverseTraceEvent& Event, double& OutStartTime, double& OutEndTime);
+	
+	static uint32 GetEventDepth(const FAmbiverseTraceEvent& Event);
+	static uint32 GetEventColor(const FAmbiverseTraceEvent& Event);
+
+	/** Finds the event that is drawn at a time and depth. */
+	bool FindEvent(const double StartTime, const double EndTime, const uint32 Depth, FAmbiverseTraceEvent& OutEvent) const;
+};
@@ -0,0 +1,30 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Insights/ITimingViewExtender.h"
+
+class FAmbiverseTimingTrack;
+
+/** Adds the Ambiverse track to the timing view once a session contains Ambiverse events. */
+class FAmbiverseTimingViewExtender : public Insights::ITimingViewExtender
+{
+	struct FPerSessionData
+	{
+		TSharedPtr<FAmbiverseTimingTrack> Track;
+	};
+
+	TMap<Insights::ITimingViewSession*, FPerSessionData> PerSessionDataMap;
+
+	bool IsTrackVisible {true};
+
+public:
+	virtual void OnBeginSession(Insights::ITimingViewSession& InSession) override;
+	virtual void OnEndSession(Insights::ITimingViewSession& InSession) override;
+	virtual void Tick(Insights::ITimingViewSession& InSession, const TraceServices::IAnalysisSession& InAnalysisSession) override;
+	virtual void ExtendFilterMenu(Insights::ITimingViewSession& InSession, FMenuBuilder& InMenuBuilder) override;
+
+private:
+	void ToggleTrackVisibility();
+};
@@ -0,0 +1,32 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Analyzer.h"
+
+class FAmbiverseTraceProvider;
+
+namespace TraceServices { class IAnalysisSession; }
+
+/** Reads the events of the AmbiverseChannel trace channel into the Ambiverse trace provider. */
+class FAmbiverseTraceAnalyzer : public UE::Trace::IAnalyzer
+{
+public:
+	FAmbiverseTraceAnalyzer(TraceServices::IAnalysisSession& InSession, FAmbiverseTraceProvider& InProvider);
+
+	virtual void OnAnalysisBegin(const FOnAnalysisContext& Context) override;
+	virtual bool OnEvent(uint16 RouteId, EStyle Style, const FOnEventContext& Context) override;
+
+private:
+	enum : uint16
+	{
+		RouteId_Name,
+		RouteId_ElementFired,
+		RouteId_VoiceRequest,
+		RouteId_ParameterChanged,
+	};
+
+	TraceServices::IAnalysisSession& Session;
+	FAmbiverseTraceProvider& Provider;
+};
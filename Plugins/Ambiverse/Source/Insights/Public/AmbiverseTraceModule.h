@@ -0,0 +1,19 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TraceServices/ModuleService.h"
+
+/** Registers the Ambiverse analyzer and provider with every analysis session. */
+class FAmbiverseTraceModule : public TraceServices::IModule
+{
+public:
+	static FName ModuleName;
+	
+	virtual void GetModuleInfo(TraceServices::FModuleInfo& OutModuleInfo) override;
+	virtual void OnAnalysisBegin(TraceServices::IAnalysisSession& InSession) override;
+	virtual void GetLoggers(TArray<const TCHAR*>& OutLoggers) override;
+	virtual void GenerateReports(const TraceServices::IAnalysisSession& Session, const TCHAR* CmdLine, const TCHAR* OutputDirectory) override {}
+	virtual const TCHAR* GetCommandLineArgumentForInitialization() const override { return TEXT("ambiversetrace"); }
+};
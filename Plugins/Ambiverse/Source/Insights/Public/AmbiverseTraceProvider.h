@@ -0,0 +1,65 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+enum class EAmbiverseTraceEventType : uint8
+{
+	ElementFired,
+	VoiceRequest,
+	ParameterChanged
+};
+
+/** A single analyzed Ambiverse trace event. */
+struct FAmbiverseTraceEvent
+{
+	/** The time of the event in seconds since the start of the session. */
+	double Time {0.0};
+
+	/** The element or parameter the event belongs to. */
+	uint64 NameId {0};
+
+	/** The layer and sound of a fired element. */
+	uint64 LayerId {0};
+	uint64 SoundId {0};
+
+	FVector3f Location {FVector3f::ZeroVector};
+
+	/** The deferral latency of a fired element, or the new value of a parameter. */
+	float Value {0.0f};
+
+	EAmbiverseTraceEventType Type {EAmbiverseTraceEventType::ElementFired};
+
+	/** The EAmbiverseTraceVoiceResult of a voice request. */
+	uint8 VoiceResult {0};
+};
+
+/** Stores the Ambiverse events of an analysis session in the order they were traced. */
+class FAmbiverseTraceProvider : public TraceServices::IProvider
+{
+public:
+	static FName ProviderName;
+
+	explicit FAmbiverseTraceProvider(TraceServices::IAnalysisSession& InSession);
+
+	void AppendName(const uint64 Id, const TCHAR* Name);
+	void AppendEvent(const FAmbiverseTraceEvent& Event);
+
+	/** Returns the name that was traced for an ID, or an empty string if it is unknown. */
+	const TCHAR* GetName(const uint64 Id) const;
+
+	/** Calls the callback for every event between the start and end time. */
+	void EnumerateEvents(const double StartTime, const double EndTime, TFunctionRef<void(const FAmbiverseTraceEvent&)> Callback) const;
+
+	FORCEINLINE int32 GetEventCount() const { return Events.Num(); }
+
+private:
+	TraceServices::IAnalysisSession& Session;
+
+	TArray<FAmbiverseTraceEvent> Events;
+
+	/** Names are stored in the string store of the session, so the pointers stay valid for the lifetime of the session. */
+	TMap<uint64, const TCHAR*> Names;
+};
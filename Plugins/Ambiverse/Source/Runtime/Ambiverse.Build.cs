@@ -39,6 +39,8 @@ public class Ambiverse : ModuleRules
 				"Slate",
 				"SlateCore",
 				"MetasoundEngine",
+				"MetasoundFrontend",
+				"AudioExtensions",
 			}
 			);
 		
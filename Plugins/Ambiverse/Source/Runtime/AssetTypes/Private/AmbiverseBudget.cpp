@@ -0,0 +1,198 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseBudget.h"
+#include "AmbiverseComposite.h"
+#include "AmbiverseDistributor.h"
+#include "AmbiverseElement.h"
+#include "AmbiverseLayer.h"
+#include "Sound/SoundWave.h"
+
+#define LOCTEXT_NAMESPACE "AmbiverseBudget"
+
+FAmbiverseBudgetEstimate FAmbiverseBudgetEstimate::EstimateElement(const UAmbiverseElement* Element, const float MaxFiresPerSecond,
+	const float MeanFiresPerSecond, TSet<const UObject*>& CountedSounds)
+{
+	FAmbiverseBudgetEstimate Estimate;
+	if (!Element) { return Estimate; }
+
+	Estimate.FiresPerSecond = MaxFiresPerSecond;
+
+	/** By Little's law, the average number of voices is the average fire rate multiplied by the average voice duration. */
+	Estimate.ConcurrentVoices = MeanFiresPerSecond * GetMeanSoundDuration(Element);
+
+	if (Element->DistributorClass)
+	{
+		const UAmbiverseDistributor* Distributor {Element->DistributorClass->GetDefaultObject<UAmbiverseDistributor>()};
+		Estimate.TracesPerSecond = MaxFiresPerSecond * Distributor->EstimatedTracesPerDistribution;
+	}
+
+	for (const TPair<UMetaSoundSource*, int>& SoundWeightPair : Element->Sounds)
+	{
+		Estimate.SoundMemoryBytes += GetSoundMemory(SoundWeightPair.Key, CountedSounds);
+	}
+	
+	return Estimate;
+}
+
+FAmbiverseBudgetEstimate FAmbiverseBudgetEstimate::EstimateLayer(const UAmbiverseLayer* Layer, TSet<const UObject*>& CountedSounds)
+{
+	FAmbiverseBudgetEstimate Estimate;
+	if (!Layer || !Layer->IsEnabled) { return Estimate; }
+
+	const float MaxDensity {GetMaxDensity(Layer)};
+
+	for (const FAmbiverseProceduralElement& ProceduralElement : Layer->ProceduralElements)
+	{
+		if (!ProceduralElement.IsValid()) { continue; }
+
+		/** A bed is never fired. It plays one voice, and a second one while it crossfades. */
+		if (ProceduralElement.Element->IsBed())
+		{
+			FAmbiverseBudgetEstimate BedEstimate {EstimateElement(ProceduralElement.Element, 0.0f, 0.0f, CountedSounds)};
+			const UAmbiverseElement* Element {ProceduralElement.Element};
+			BedEstimate.ConcurrentVoices = Element->BedCrossfadeInterval > 0.0f
+				? 1.0f + FMath::Min(Element->BedCrossfadeDuration / Element->BedCrossfadeInterval, 1.0f) : 1.0f;
+			Estimate += BedEstimate;
+			continue;
+		}
+
+		/** Intervals are drawn uniformly from the interval range and divided by the density. */
+		const float MinInterval {FMath::Max(static_cast<float>(ProceduralElement.IntervalRange.X), UE_KINDA_SMALL_NUMBER)};
+		const float MeanInterval {FMath::Max(static_cast<float>(ProceduralElement.IntervalRange.X + ProceduralElement.IntervalRange.Y) * 0.5f, UE_KINDA_SMALL_NUMBER)};
+
+		float ElementMaxDensity {MaxDensity};
+		for (const FAmbiverseParameterModifiers& Modifiers : ProceduralElement.Parameters)
+		{
+			ElementMaxDensity *= Modifiers.GetMaxDensity();
+		}
+
+		Estimate += EstimateElement(ProceduralElement.Element, ElementMaxDensity / MinInterval, ElementMaxDensity / MeanInterval, CountedSounds);
+	}
+	
+	return Estimate;
+}
+
+FAmbiverseBudgetEstimate FAmbiverseBudgetEstimate::EstimateComposite(const UAmbiverseComposite* Composite)
+{
+	FAmbiverseBudgetEstimate Estimate;
+	if (!Composite) { return Estimate; }
+
+	TSet<const UObject*> CountedSounds;
+	TSet<const UAmbiverseLayer*> CountedLayers;
+	
+	for (const UAmbiverseLayer* Layer : Composite->Layers)
+	{
+		if (!Layer || CountedLayers.Contains(Layer)) { continue; }
+		CountedLayers.Add(Layer);
+		
+		Estimate += EstimateLayer(Layer, CountedSounds);
+	}
+	
+	return Estimate;
+}
+
+float FAmbiverseBudgetEstimate::GetMaxDensity(const UAmbiverseLayer* Layer)
+{
+	if (!Layer) { return 0.0f; }
+
+	float MaxDensity {Layer->LayerDensity};
+	for (const FAmbiverseParameterModifiers& Modifiers : Layer->Parameters)
+	{
+		MaxDensity *= Modifiers.GetMaxDensity();
+	}
+	
+	return MaxDensity;
+}
+
+float FAmbiverseBudgetEstimate::GetMeanSoundDuration(const UAmbiverseElement* Element)
+{
+	if (!Element) { return 0.0f; }
+	
+	int32 TotalWeight {0};
+	float WeightedDuration {0.0f};
+	
+	for (const TPair<UMetaSoundSource*, int>& SoundWeightPair : Element->Sounds)
+	{
+		if (!SoundWeightPair.Key) { continue; }
+
+		/** Looping and procedural sounds report an infinite or zero duration. */
+		float Duration {SoundWeightPair.Key->GetDuration()};
+		if (Duration <= 0.0f || Duration >= INDEFINITELY_LOOPING_DURATION)
+		{
+			Duration = Element->DistributionData.FallbackSoundDuration;
+		}
+
+		/** An element with invalid weights selects its sounds evenly. */
+		const int32 Weight {FMath::Max(1, SoundWeightPair.Value)};
+		TotalWeight += Weight;
+		WeightedDuration += Duration * Weight;
+	}
+	
+	return TotalWeight > 0 ? WeightedDuration / TotalWeight : 0.0f;
+}
+
+TArray<FText> FAmbiverseBudgetEstimate::GetExceededBudgets(const FAmbiverseBudget& Budget) const
+{
+	TArray<FText> Messages;
+	const float SoundMemoryMB {static_cast<float>(SoundMemoryBytes) / (1024.0f * 1024.0f)};
+
+	if (FiresPerSecond > Budget.MaxFiresPerSecond)
+	{
+		Messages.Add(FText::Format(LOCTEXT("FiresExceeded", "Worst-case fire rate of {0} per second exceeds the budget of {1}."),
+			FText::AsNumber(FiresPerSecond), FText::AsNumber(Budget.MaxFiresPerSecond)));
+	}
+	
+	if (ConcurrentVoices > Budget.MaxConcurrentVoices)
+	{
+		Messages.Add(FText::Format(LOCTEXT("VoicesExceeded", "Expected {0} concurrent voices exceeds the budget of {1}."),
+			FText::AsNumber(ConcurrentVoices), FText::AsNumber(Budget.MaxConcurrentVoices)));
+	}
+	
+	if (SoundMemoryMB > Budget.MaxSoundMemoryMB)
+	{
+		Messages.Add(FText::Format(LOCTEXT("MemoryExceeded", "Sound memory of {0} MB exceeds the budget of {1} MB."),
+			FText::AsNumber(SoundMemoryMB), FText::AsNumber(Budget.MaxSoundMemoryMB)));
+	}
+	
+	if (TracesPerSecond > Budget.MaxTracesPerSecond)
+	{
+		Messages.Add(FText::Format(LOCTEXT("TracesExceeded", "Worst-case trace rate of {0} per second exceeds the budget of {1}."),
+			FText::AsNumber(TracesPerSecond), FText::AsNumber(Budget.MaxTracesPerSecond)));
+	}
+	
+	return Messages;
+}
+
+FAmbiverseBudgetEstimate& FAmbiverseBudgetEstimate::operator+=(const FAmbiverseBudgetEstimate& Other)
+{
+	FiresPerSecond += Other.FiresPerSecond;
+	ConcurrentVoices += Other.ConcurrentVoices;
+	TracesPerSecond += Other.TracesPerSecond;
+	SoundMemoryBytes += Other.SoundMemoryBytes;
+	return *this;
+}
+
+int64 FAmbiverseBudgetEstimate::GetSoundMemory(UObject* Sound, TSet<const UObject*>& CountedSounds)
+{
+	if (!Sound || CountedSounds.Contains(Sound)) { return 0; }
+	CountedSounds.Add(Sound);
+
+	int64 MemoryBytes {Sound->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal)};
+
+	/** A MetaSound holds no audio data itself. Its memory is mostly that of the sound waves referenced by its graph. */
+	TArray<UObject*> References;
+	FReferenceFinder ReferenceFinder(References, nullptr, false, true, false);
+	ReferenceFinder.FindReferences(Sound);
+
+	for (UObject* Reference : References)
+	{
+		if (Reference && Reference->IsA<USoundWave>())
+		{
+			MemoryBytes += GetSoundMemory(Reference, CountedSounds);
+		}
+	}
+	
+	return MemoryBytes;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -2,4 +2,34 @@
 
 
 #include "AmbiverseComposite.h"
+#include "UObject/ObjectSaveContext.h"
 
+DEFINE_LOG_CATEGORY_CLASS(UAmbiverseComposite, LogAmbiverseComposite);
+
+#if WITH_EDITOR
+EDataValidationResult UAmbiverseComposite::IsDataValid(TArray<FText>& ValidationErrors)
+{
+	EDataValidationResult Result {Super::IsDataValid(ValidationErrors)};
+
+	const TArray<FText> ExceededBudgets {FAmbiverseBudgetEstimate::EstimateComposite(this).GetExceededBudgets(Budget)};
+	if (!ExceededBudgets.IsEmpty())
+	{
+		ValidationErrors.Append(ExceededBudgets);
+		Result = EDataValidationResult::Invalid;
+	}
+	
+	return Result;
+}
+
+void UAmbiverseComposite::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+
+	if (!ObjectSaveContext.IsCooking()) { return; }
+
+	for (const FText& ExceededBudget : FAmbiverseBudgetEstimate::EstimateComposite(this).GetExceededBudgets(Budget))
+	{
+		UE_LOG(LogAmbiverseComposite, Warning, TEXT("PreSave: '%s' is over budget. %s"), *GetPathName(), *ExceededBudget.ToString());
+	}
+}
+#endif
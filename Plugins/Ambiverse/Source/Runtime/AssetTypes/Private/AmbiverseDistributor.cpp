@@ -1,83 +1,111 @@
 // Copyright (c) 2023-present Tim Verberne. All rights reserved.
 
 #include "AmbiverseDistributor.h"
+#include "AmbiverseDistributorManager.h"
+#include "AmbiverseSpawnPointTable.h"
+#include "AmbiverseStats.h"
+#include "AmbiverseSubsystem.h"
 
 DEFINE_LOG_CATEGORY_CLASS(UAmbiverseDistributor, LogAmbiverseDistributor);
 
-void UAmbiverseDistributor::Activate(UObject* WorldContextObject)
+/** The time in seconds after which a batch of asynchronous traces is considered lost. Async traces normally complete in the next frame. */
+static constexpr double TraceBatchTimeout {5.0};
+
+void UAmbiverseDistributor::BeginDestroy()
 {
-	if (WorldContextObject)
-	{
-		if (APlayerController* PlayerController {WorldContextObject->GetWorld()->GetFirstPlayerController()})
-		{
-			if (APlayerCameraManager* CameraManager {PlayerController->PlayerCameraManager})
-			{
-				Listener = CameraManager->GetViewTarget();
-			}
-		}
-	}
+	/** Traces that are still in flight are ignored, as the delegate is bound weakly. */
+	PendingTraceBatches.Empty();
+	AsyncTraceDelegate.Unbind();
+	
+	Super::BeginDestroy();
 }
 
 FVector UAmbiverseDistributor::GetRandomPointInRadiusAroundListener(float Radius)
 {
-	if (!Listener)
+	if (!ListenerState.IsValid)
 	{
-		UE_LOG(LogAmbiverseDistributor, Warning, TEXT("GetRandomPointInRadiusAroundListener: Listener is null."));
+		UE_LOG(LogAmbiverseDistributor, Warning, TEXT("GetRandomPointInRadiusAroundListener: Listener is invalid."));
 		return FVector{0.0f, 0.0f, 0.0f};
 	}
 
-	const float RandomAngle {FMath::RandRange(0.0f, 2 * PI)};
-	const float RandomRadius {FMath::Sqrt(FMath::RandRange(0.0f, FMath::Square(Radius)))};
+	const FAmbiverseSpawnPoint& Point {FAmbiverseSpawnPointTable::GetNextPoint(FAmbiverseSpawnPointTable::GetAnnulusTable(), SpawnPointCursor)};
+
+	const FVector& ListenerLocation {ListenerState.Location};
 
-	const double X {Listener->GetActorLocation().X + RandomRadius * FMath::Cos(RandomAngle)};
-	const double Y {Listener->GetActorLocation().Y + RandomRadius * FMath::Sin(RandomAngle)};
-	const double Z {Listener->GetActorLocation().Z};
+	const double X {ListenerLocation.X + Point.Position.X * Radius};
+	const double Y {ListenerLocation.Y + Point.Position.Y * Radius};
+	const double Z {ListenerLocation.Z};
 
 	return FVector{X, Y, Z};
 }
 
 FVector UAmbiverseDistributor::GetPointAtDistanceAndAngleFromListener(float Distance, float Angle)
 {
-	if (!Listener)
+	if (!ListenerState.IsValid)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("GetPointAtDistanceAndAngleFromListener: Listener is null."));
+		UE_LOG(LogTemp, Warning, TEXT("GetPointAtDistanceAndAngleFromListener: Listener is invalid."));
 		return FVector{0.0f, 0.0f, 0.0f};
 	}
 
-	const double X {Listener->GetActorLocation().X + Distance * FMath::Cos(Angle)};
-	const double Y {Listener->GetActorLocation().Y + Distance * FMath::Sin(Angle)};
-	const double Z {Listener->GetActorLocation().Z};
+	float Sin, Cos;
+	FMath::SinCos(&Sin, &Cos, Angle);
+
+	const FVector& ListenerLocation {ListenerState.Location};
+
+	const double X {ListenerLocation.X + Distance * Cos};
+	const double Y {ListenerLocation.Y + Distance * Sin};
+	const double Z {ListenerLocation.Z};
 
 	return FVector{X, Y, Z};
 }
 
 void UAmbiverseDistributor::SnapToFloor(FVector& Location, float Offset)
 {
-	if (UWorld* World {GetWorldFromListener()})
+	UWorld* World {GetWorldFromListener()};
+	if (!World) { return; }
+
+	float TraceHalfHeight {5000.0f};
+	
+	if (const UAmbiverseDistributorManager* DistributorManager {GetTypedOuter<UAmbiverseDistributorManager>()})
 	{
-		const FVector StartLocation {Listener->GetActorLocation()};
-		const FVector EndLocation {StartLocation + FVector{0.0f, 0.0f, -FLT_MAX}};
+		const FAmbiverseFloorCache& FloorCache {DistributorManager->GetFloorCache()};
+		
+		float FloorHeight {0.0f};
+		if (FloorCache.SampleHeight(FVector2D(Location), FloorHeight))
+		{
+			Location.Z = FloorHeight + Offset;
+			return;
+		}
 
-		FHitResult HitResult;
-		FCollisionQueryParams TraceParams(FName(TEXT("SnapToFloorTrace")), true, Listener);
-		TraceParams.bTraceComplex = false;
+		TraceHalfHeight = FloorCache.GetTraceHalfHeight();
+	}
 
-		const bool Hit {World->LineTraceSingleByChannel(
-			HitResult,
-			StartLocation,
-			EndLocation,
-			ECC_Visibility,
-			TraceParams
-		)};
+	SCOPE_CYCLE_COUNTER(STAT_AmbiverseTracing);
+	CountTraces(1);
 
-		if (Hit)
-		{
-			Location = HitResult.Location + FVector(0, 0, Offset);
-		}
-		else
-		{
-			UE_LOG(LogTemp, Warning, TEXT("SnapToFloor: Failed to snap to floor."));
-		}
+	/** If the floor cache has no data for this location yet, we fall back to a bounded trace at the location. */
+	const FVector StartLocation {Location.X, Location.Y, ListenerState.Location.Z + TraceHalfHeight};
+	const FVector EndLocation {Location.X, Location.Y, ListenerState.Location.Z - TraceHalfHeight};
+
+	FHitResult HitResult;
+	FCollisionQueryParams TraceParams(FName(TEXT("SnapToFloorTrace")), true, ListenerState.ViewTarget.Get());
+	TraceParams.bTraceComplex = false;
+
+	const bool Hit {World->LineTraceSingleByChannel(
+		HitResult,
+		StartLocation,
+		EndLocation,
+		ECC_Visibility,
+		TraceParams
+	)};
+
+	if (Hit)
+	{
+		Location = HitResult.Location + FVector(0, 0, Offset);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SnapToFloor: Failed to snap to floor."));
 	}
 }
 
@@ -89,12 +117,15 @@ void UAmbiverseDistributor::SetLocationByTrace(FVector& Location, float Offset)
 		return;
 	}
 
-	const FVector StartLocation {Listener->GetActorLocation()};
+	SCOPE_CYCLE_COUNTER(STAT_AmbiverseTracing);
+	CountTraces(1);
+
+	const FVector StartLocation {ListenerState.Location};
 	const FVector EndLocation {Location};
 	const FVector TraceDirection {(EndLocation - StartLocation).GetSafeNormal()};
 
 	FHitResult HitResult;
-	FCollisionQueryParams TraceParams(FName(TEXT("SetLocationByTraceTrace")), true, Listener);
+	FCollisionQueryParams TraceParams(FName(TEXT("SetLocationByTraceTrace")), true, ListenerState.ViewTarget.Get());
 	TraceParams.bTraceComplex = true;
 
 	const bool Hit {World->LineTraceSingleByChannel(
@@ -115,13 +146,201 @@ void UAmbiverseDistributor::SetLocationByTrace(FVector& Location, float Offset)
 	}
 }
 
+int32 UAmbiverseDistributor::TraceCandidates(const TArray<FVector>& Candidates, TArray<FHitResult>& HitResults,
+	EAmbiverseCandidateSelection Selection, float TraceHalfHeight)
+{
+	HitResults.Reset(Candidates.Num());
+	HitResults.SetNum(Candidates.Num());
+	
+	UWorld* World {GetWorldFromListener()};
+	if (!World || Candidates.IsEmpty()) { return INDEX_NONE; }
+
+	SCOPE_CYCLE_COUNTER(STAT_AmbiverseTracing);
+
+	/** The query parameters are shared by all traces in the batch. */
+	FCollisionQueryParams TraceParams(FName(TEXT("TraceCandidatesTrace")), false, ListenerState.ViewTarget.Get());
+	const FVector TraceExtent {0.0f, 0.0f, TraceHalfHeight};
+
+	for (int32 Index {0}; Index < Candidates.Num(); ++Index)
+	{
+		FHitResult& HitResult {HitResults[Index]};
+		World->LineTraceSingleByChannel(HitResult, Candidates[Index] + TraceExtent, Candidates[Index] - TraceExtent, ECC_Visibility, TraceParams);
+		CountTraces(1);
+
+		/** If we're only interested in the first valid candidate, there is no need to trace the remaining candidates. */
+		if (Selection == EAmbiverseCandidateSelection::FirstValid && HitResult.bBlockingHit)
+		{
+			return Index;
+		}
+	}
+
+	return SelectCandidate(HitResults, Selection);
+}
+
+bool UAmbiverseDistributor::TraceCandidatesAsync(const TArray<FVector>& Candidates, const FOnAmbiverseCandidatesTraced& OnCompleted,
+	EAmbiverseCandidateSelection Selection, float TraceHalfHeight)
+{
+	UWorld* World {GetWorldFromListener()};
+	if (!World || Candidates.IsEmpty()) { return false; }
+
+	/** The batch ID and candidate index are packed together in the user data of the trace. */
+	if (Candidates.Num() > MAX_uint16)
+	{
+		UE_LOG(LogAmbiverseDistributor, Warning, TEXT("TraceCandidatesAsync: Too many candidates in batch: %d."), Candidates.Num());
+		return false;
+	}
+	
+	if (!AsyncTraceDelegate.IsBound())
+	{
+		AsyncTraceDelegate.BindUObject(this, &UAmbiverseDistributor::HandleAsyncTraceCompleted);
+	}
+
+	ExpireTraceBatches();
+
+	/** Batch IDs wrap around, so IDs of batches that are still pending are skipped instead of overwriting them. */
+	if (PendingTraceBatches.Num() > MAX_uint16)
+	{
+		UE_LOG(LogAmbiverseDistributor, Warning, TEXT("TraceCandidatesAsync: Too many pending batches: %d."), PendingTraceBatches.Num());
+		return false;
+	}
+	
+	while (PendingTraceBatches.Contains(NextTraceBatchID))
+	{
+		++NextTraceBatchID;
+	}
+	const uint16 BatchID {NextTraceBatchID++};
+	
+	FAmbiverseTraceBatch& Batch {PendingTraceBatches.Add(BatchID)};
+	Batch.IssueTime = FPlatformTime::Seconds();
+	Batch.HitResults.SetNum(Candidates.Num());
+	Batch.PendingTraceCount = Candidates.Num();
+	Batch.Selection = Selection;
+	Batch.OnCompleted = OnCompleted;
+	
+	FCollisionQueryParams TraceParams(FName(TEXT("TraceCandidatesAsyncTrace")), false, ListenerState.ViewTarget.Get());
+	const FVector TraceExtent {0.0f, 0.0f, TraceHalfHeight};
+
+	for (int32 Index {0}; Index < Candidates.Num(); ++Index)
+	{
+		const uint32 UserData {static_cast<uint32>(BatchID) << 16 | static_cast<uint32>(Index)};
+		
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Candidates[Index] + TraceExtent, Candidates[Index] - TraceExtent,
+			ECC_Visibility, TraceParams, FCollisionResponseParams::DefaultResponseParam, &AsyncTraceDelegate, UserData);
+	}
+
+	CountTraces(Candidates.Num());
+	return true;
+}
+
+void UAmbiverseDistributor::HandleAsyncTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const uint16 BatchID {static_cast<uint16>(TraceDatum.UserData >> 16)};
+	const int32 Index {static_cast<int32>(TraceDatum.UserData & 0xFFFF)};
+
+	FAmbiverseTraceBatch* Batch {PendingTraceBatches.Find(BatchID)};
+	if (!Batch) { return; }
+
+	if (Batch->IsExpired)
+	{
+		if (--Batch->PendingTraceCount <= 0)
+		{
+			PendingTraceBatches.Remove(BatchID);
+		}
+		return;
+	}
+
+	if (!Batch->HitResults.IsValidIndex(Index)) { return; }
+
+	if (TraceDatum.OutHits.Num() > 0)
+	{
+		Batch->HitResults[Index] = TraceDatum.OutHits[0];
+	}
+	else
+	{
+		Batch->HitResults[Index] = FHitResult(TraceDatum.Start, TraceDatum.End);
+	}
+
+	if (--Batch->PendingTraceCount > 0) { return; }
+
+	const FAmbiverseTraceBatch CompletedBatch {MoveTemp(*Batch)};
+	PendingTraceBatches.Remove(BatchID);
+	
+	CompletedBatch.OnCompleted.ExecuteIfBound(CompletedBatch.HitResults, SelectCandidate(CompletedBatch.HitResults, CompletedBatch.Selection));
+}
+
+void UAmbiverseDistributor::ExpireTraceBatches()
+{
+	if (PendingTraceBatches.IsEmpty()) { return; }
+
+	const double ExpiryTime {FPlatformTime::Seconds() - TraceBatchTimeout};
+	
+	for (auto Iterator {PendingTraceBatches.CreateIterator()}; Iterator; ++Iterator)
+	{
+		FAmbiverseTraceBatch& Batch {Iterator.Value()};
+		if (Batch.IsExpired || Batch.IssueTime >= ExpiryTime) { continue; }
+		
+		UE_LOG(LogAmbiverseDistributor, Verbose, TEXT("ExpireTraceBatches: Batch %d expired with %d pending traces."),
+			Iterator.Key(), Batch.PendingTraceCount);
+
+		/** The ID stays reserved until the remaining traces have returned. */
+		Batch.IsExpired = true;
+		Batch.OnCompleted.Unbind();
+		Batch.HitResults.Empty();
+	}
+}
+
+int32 UAmbiverseDistributor::SelectCandidate(const TArray<FHitResult>& HitResults, const EAmbiverseCandidateSelection Selection)
+{
+	if (Selection == EAmbiverseCandidateSelection::None) { return INDEX_NONE; }
+
+	int32 SelectedIndex {INDEX_NONE};
+	float HighestScore {-FLT_MAX};
+	
+	for (int32 Index {0}; Index < HitResults.Num(); ++Index)
+	{
+		if (!HitResults[Index].bBlockingHit) { continue; }
+
+		if (Selection == EAmbiverseCandidateSelection::FirstValid) { return Index; }
+
+		const float Score {ScoreCandidate(HitResults[Index])};
+		if (Score > HighestScore)
+		{
+			HighestScore = Score;
+			SelectedIndex = Index;
+		}
+	}
+
+	return SelectedIndex;
+}
+
+float UAmbiverseDistributor::ScoreCandidate_Implementation(const FHitResult& HitResult)
+{
+	/** Flat surfaces score up to 1, and every meter of height difference with the listener costs a tenth of a point. */
+	float Score {static_cast<float>(HitResult.ImpactNormal.Z)};
+	
+	if (ListenerState.IsValid)
+	{
+		Score -= FMath::Abs(HitResult.ImpactPoint.Z - ListenerState.Location.Z) * 0.001f;
+	}
+	
+	return Score;
+}
+
 UWorld* UAmbiverseDistributor::GetWorldFromListener()
 {
-	if (!Listener)
+	if (!ListenerState.IsValid)
 	{
-		UE_LOG(LogAmbiverseDistributor, Warning, TEXT("GetWorldFromListener: Listener is null."));
+		UE_LOG(LogAmbiverseDistributor, Warning, TEXT("GetWorldFromListener: Listener is invalid."));
 		return nullptr;
 	}
 
-	return {Listener->GetWorld()};
+	return {GetWorld()};
+}
+
+void UAmbiverseDistributor::CountTraces(const int32 TraceCount) const
+{
+	if (UAmbiverseSubsystem* Subsystem {GetTypedOuter<UAmbiverseSubsystem>()})
+	{
+		Subsystem->GetFrameCounters().Traces += TraceCount;
+	}
 }
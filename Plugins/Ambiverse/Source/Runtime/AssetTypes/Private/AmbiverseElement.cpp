@@ -1,6 +1,9 @@
 // Copyright (c) 2023-present Tim Verberne. All rights reserved.
 
 #include "AmbiverseElement.h"
+#include "AmbiverseFarFieldManager.h"
+#include "AmbiverseParameter.h"
+#include "AudioParameter.h"
 
 DEFINE_LOG_CATEGORY_CLASS(UAmbiverseElement, LogAmbiverseElement);
 
@@ -42,6 +45,18 @@ UMetaSoundSource* UAmbiverseElement::GetSoundFromMap(const TMap<UMetaSoundSource
 	return nullptr;
 }
 
+void UAmbiverseElement::GetForwardedParameters(TArray<FAudioParameter>& OutAudioParameters, const TArray<UAmbiverseParameter*>* ChangedParameters) const
+{
+	for (const FAmbiverseParameterForwarding& Forwarding : ForwardedParameters)
+	{
+		if (!Forwarding.Parameter || Forwarding.InputName.IsNone()) { continue; }
+		if (ChangedParameters && !ChangedParameters->Contains(Forwarding.Parameter)) { continue; }
+
+		const float Value {Forwarding.UseNormalizedValue ? Forwarding.Parameter->ParameterValue : Forwarding.Parameter->GetValue()};
+		OutAudioParameters.Emplace(Forwarding.InputName, Value);
+	}
+}
+
 #if WITH_EDITOR
 void UAmbiverseElement::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
 {
@@ -58,5 +73,19 @@ void UAmbiverseElement::PostEditChangeProperty(struct FPropertyChangedEvent& Pro
 		}
 	}
 }
+
+EDataValidationResult UAmbiverseElement::IsDataValid(TArray<FText>& ValidationErrors)
+{
+	EDataValidationResult Result {Super::IsDataValid(ValidationErrors)};
+
+	const TArray<FText> FarFieldErrors {UAmbiverseFarFieldManager::ValidateFarFieldSource(FarFieldSource)};
+	if (!FarFieldErrors.IsEmpty())
+	{
+		ValidationErrors.Append(FarFieldErrors);
+		Result = EDataValidationResult::Invalid;
+	}
+	
+	return Result;
+}
 #endif
 
@@ -2,9 +2,23 @@
 
 #include "AmbiverseLayer.h"
 #include "AmbiverseParameterManager.h"
+#include "UObject/ObjectSaveContext.h"
 
 DEFINE_LOG_CATEGORY_CLASS(UAmbiverseLayer, LogAmbiverseLayer);
 
+void UAmbiverseLayer::Compile()
+{
+	ProceduralElements.RemoveAll([](const FAmbiverseProceduralElement& Element){ return !Element.IsValid(); });
+	CompiledLayer.Compile(ProceduralElements, Parameters);
+}
+
+float UAmbiverseLayer::GetLifetimeFade() const
+{
+	if (!EnableLifetime || FadeStartRatio >= 1.0f) { return 1.0f; }
+
+	return FMath::Clamp(1.0f - (LifetimeRatio - FadeStartRatio) / (1.0f - FadeStartRatio), 0.0f, 1.0f);
+}
+
 #if WITH_EDITOR
 void UAmbiverseLayer::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
 {
@@ -26,5 +40,19 @@ void UAmbiverseLayer::PostEditChangeProperty(struct FPropertyChangedEvent& Prope
 		}
 	}
 }
-#endif
 
+void UAmbiverseLayer::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+
+	/** Layers are only compiled when cooked. In the editor, a layer is compiled every time it is registered, so it reflects the latest edits. */
+	if (ObjectSaveContext.IsCooking())
+	{
+		Compile();
+	}
+	else
+	{
+		CompiledLayer.Reset();
+	}
+}
+#endif
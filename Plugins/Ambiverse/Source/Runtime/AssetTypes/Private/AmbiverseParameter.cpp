@@ -4,10 +4,55 @@
 
 float UAmbiverseParameter::SetParameter(float Value)
 {
-	ParameterValue = FMath::GetMappedRangeValueClamped(ParameterRange, FVector2D(0, 1), Value);
+	ParameterValue = GetNormalizedValue(Value);
 	return ParameterValue;
 }
 
+float UAmbiverseParameter::GetValue() const
+{
+	return static_cast<float>(FMath::Lerp(ParameterRange.X, ParameterRange.Y, static_cast<double>(ParameterValue)));
+}
+
+float UAmbiverseParameter::GetNormalizedValue(const float Value) const
+{
+	return FMath::GetMappedRangeValueClamped(ParameterRange, FVector2D(0, 1), Value);
+}
+
+float UAmbiverseParameter::SmoothValue(const float Value, const float Target, float& Velocity, const float DeltaTime) const
+{
+	switch (Smoothing)
+	{
+	case EAmbiverseParameterSmoothing::Slew:
+		{
+			const float MaxStep {SlewRate * DeltaTime};
+			Velocity = 0.0f;
+			return Value + FMath::Clamp(Target - Value, -MaxStep, MaxStep);
+		}
+	case EAmbiverseParameterSmoothing::CriticallyDamped:
+		{
+			/** Closed form critically damped spring, using a polynomial approximation of the exponential decay. Stable for any delta time. */
+			const float Omega {2.0f / FMath::Max(SmoothingTime, KINDA_SMALL_NUMBER)};
+			const float X {Omega * DeltaTime};
+			const float Decay {1.0f / (1.0f + X + 0.48f * X * X + 0.235f * X * X * X)};
+			const float Offset {Value - Target};
+			const float Temp {(Velocity + Omega * Offset) * DeltaTime};
+			Velocity = (Velocity - Omega * Temp) * Decay;
+			
+			/** Snap to the target once the remaining movement is inaudible, so the parameter stops reporting changes. */
+			const float Result {Target + (Offset + Temp) * Decay};
+			if (FMath::Abs(Result - Target) < KINDA_SMALL_NUMBER && FMath::Abs(Velocity) < KINDA_SMALL_NUMBER)
+			{
+				Velocity = 0.0f;
+				return Target;
+			}
+			return Result;
+		}
+	default:
+		Velocity = 0.0f;
+		return Target;
+	}
+}
+
 void UAmbiverseParameter::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	{
@@ -19,3 +64,37 @@ void UAmbiverseParameter::PostEditChangeProperty(FPropertyChangedEvent& Property
 		}
 	}
 }
+
+float FAmbiverseParameterModifiers::GetVolume(const float Alpha) const
+{
+	if (UseCurves)
+	{
+		return FMath::Max(0.0f, VolumeCurve.GetRichCurveConst()->Eval(Alpha, 1.0f));
+	}
+	return static_cast<float>(FMath::GetMappedRangeValueClamped(FVector2D(0, 1), VolumeRange, Alpha));
+}
+
+float FAmbiverseParameterModifiers::GetDensity(const float Alpha) const
+{
+	if (UseCurves)
+	{
+		return FMath::Max(0.0f, DensityCurve.GetRichCurveConst()->Eval(Alpha, 1.0f));
+	}
+	return static_cast<float>(FMath::GetMappedRangeValueClamped(FVector2D(0, 1), DensityRange, Alpha));
+}
+
+float FAmbiverseParameterModifiers::GetMaxDensity() const
+{
+	if (UseCurves)
+	{
+		const FRichCurve* Curve {DensityCurve.GetRichCurveConst()};
+		if (!Curve->HasAnyData()) { return 1.0f; }
+		
+		/** Curves are clamped to their first and last key outside of their time range, so the value range covers the whole parameter range. */
+		float MinDensity {0.0f};
+		float MaxDensity {0.0f};
+		Curve->GetValueRange(MinDensity, MaxDensity);
+		return FMath::Max(0.0f, MaxDensity);
+	}
+	return static_cast<float>(FMath::Max(DensityRange.X, DensityRange.Y));
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AmbiverseBudget.generated.h"
+
+class UAmbiverseComposite;
+class UAmbiverseElement;
+class UAmbiverseLayer;
+
+/** The maximum cost a soundscape is allowed to have. */
+USTRUCT(BlueprintType)
+struct AMBIVERSE_API FAmbiverseBudget
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The maximum number of elements that may fire per second, when every element fires at its shortest interval. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Budget", Meta = (ClampMin = "0"))
+	float MaxFiresPerSecond {4.0f};
+
+	/** The maximum number of voices that may be expected to play at the same time. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Budget", Meta = (ClampMin = "0"))
+	float MaxConcurrentVoices {16.0f};
+
+	/** The maximum memory, in megabytes, of all sounds that are referenced. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Budget", Meta = (ClampMin = "0"))
+	float MaxSoundMemoryMB {64.0f};
+
+	/** The maximum number of scene queries that distributors may issue per second, when every element fires at its shortest interval. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Budget", Meta = (ClampMin = "0"))
+	float MaxTracesPerSecond {8.0f};
+};
+
+/** An estimate of the worst-case cost of an element, layer or composite. */
+struct AMBIVERSE_API FAmbiverseBudgetEstimate
+{
+	/** The fire rate when every element fires at its shortest interval at the maximum density. */
+	float FiresPerSecond {0.0f};
+
+	/** The average number of voices playing at the maximum density. */
+	float ConcurrentVoices {0.0f};
+
+	/** The scene queries issued by distributors when every element fires at its shortest interval at the maximum density. */
+	float TracesPerSecond {0.0f};
+
+	/** The estimated memory of all unique sounds and the sound waves they reference. */
+	int64 SoundMemoryBytes {0};
+
+	/** Estimates an element that fires at the given worst-case and average rates.
+	 * @param CountedSounds Sounds that have already been counted, so sounds that are shared between elements are only counted once. */
+	static FAmbiverseBudgetEstimate EstimateElement(const UAmbiverseElement* Element, const float MaxFiresPerSecond, const float MeanFiresPerSecond,
+		TSet<const UObject*>& CountedSounds);
+
+	static FAmbiverseBudgetEstimate EstimateLayer(const UAmbiverseLayer* Layer, TSet<const UObject*>& CountedSounds);
+
+	static FAmbiverseBudgetEstimate EstimateComposite(const UAmbiverseComposite* Composite);
+
+	/** Returns the highest density multiplier a layer can reach through its parameters. */
+	static float GetMaxDensity(const UAmbiverseLayer* Layer);
+
+	/** Returns the weighted average duration of the sounds of an element. Sounds without a finite duration use the fallback duration of the element. */
+	static float GetMeanSoundDuration(const UAmbiverseElement* Element);
+
+	/** Returns a message for every budget that this estimate exceeds. */
+	TArray<FText> GetExceededBudgets(const FAmbiverseBudget& Budget) const;
+
+	FAmbiverseBudgetEstimate& operator+=(const FAmbiverseBudgetEstimate& Other);
+
+private:
+	static int64 GetSoundMemory(UObject* Sound, TSet<const UObject*>& CountedSounds);
+};
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "AmbiverseBudget.h"
 #include "AmbiverseComposite.generated.h"
 
 class UAmbiverseLayer;
@@ -13,6 +14,8 @@ class AMBIVERSE_API UAmbiverseComposite : public UObject
 {
 	GENERATED_BODY()
 
+	DECLARE_LOG_CATEGORY_CLASS(LogAmbiverseComposite, Log, All)
+
 public:
 	UPROPERTY(EditAnywhere, Category = "Layers", Meta = (TitleProperty = "{Name}"))
 	TArray<UAmbiverseLayer*> Layers;
@@ -20,4 +23,20 @@ public:
 	/** If true, all layers that are not part of this composite are popped when this composite is pushed. */
 	UPROPERTY(EditAnywhere, Category = "Settings", Meta = (DisplayName = "Stop Non-Composite layers"))
 	bool StopNonCompositeLayers {false};
+
+	/** The time in seconds over which layers fade in and out when this composite is pushed or popped. */
+	UPROPERTY(EditAnywhere, Category = "Settings", Meta = (ClampMin = "0"))
+	float CrossfadeDuration {2.0f};
+
+#if WITH_EDITORONLY_DATA
+	/** The budget this composite is validated against. Composites that exceed their budget fail data validation and are reported when cooked. */
+	UPROPERTY(EditAnywhere, Category = "Budget")
+	FAmbiverseBudget Budget;
+#endif
+
+#if WITH_EDITOR
+	virtual EDataValidationResult IsDataValid(TArray<FText>& ValidationErrors) override;
+	
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+#endif
 };
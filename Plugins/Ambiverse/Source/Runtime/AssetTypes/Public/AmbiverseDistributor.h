@@ -3,11 +3,24 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "AmbiverseListenerState.h"
 #include "UObject/NoExportTypes.h"
+#include "WorldCollision.h"
 #include "AmbiverseDistributor.generated.h"
 
-
 class UAmbiverseElement;
+
+/** Defines how a candidate is selected from a batch of traced candidates. */
+UENUM(BlueprintType)
+enum class EAmbiverseCandidateSelection : uint8
+{
+	None			UMETA(DisplayName = "None"),
+	FirstValid		UMETA(DisplayName = "First Valid"),
+	BestScored		UMETA(DisplayName = "Best Scored"),
+};
+
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FOnAmbiverseCandidatesTraced, const TArray<FHitResult>&, HitResults, int32, SelectedIndex);
+
 UCLASS(Abstract, Blueprintable, BlueprintType, ClassGroup = "Ambiverse", Meta = (DisplayName = "Ambiverse Distributor",
 	ShortToolTip = "A distributor allows for blueprint scripting of custom spawn behavior."))
 class AMBIVERSE_API UAmbiverseDistributor : public UObject
@@ -17,11 +30,42 @@ class AMBIVERSE_API UAmbiverseDistributor : public UObject
 	DECLARE_LOG_CATEGORY_CLASS(LogAmbiverseDistributor, Log, All)
 
 private:
+	/** A snapshot of the listener, refreshed by the distributor manager every tick. */
 	UPROPERTY(Transient)
-	AActor* Listener;
+	FAmbiverseListenerState ListenerState;
+
+	/** A batch of asynchronous candidate traces that is waiting for its results. */
+	struct FAmbiverseTraceBatch
+	{
+		TArray<FHitResult> HitResults;
+		int32 PendingTraceCount {0};
+		EAmbiverseCandidateSelection Selection {EAmbiverseCandidateSelection::None};
+		FOnAmbiverseCandidatesTraced OnCompleted;
+
+		/** The platform time at which the batch was issued. Batches that never complete, for example because the world stopped tracing, expire. */
+		double IssueTime {0.0};
+
+		/** Expired batches keep their ID until their remaining traces have returned, so late results cannot reach a new batch with the same ID. */
+		bool IsExpired {false};
+	};
+
+	TMap<uint16, FAmbiverseTraceBatch> PendingTraceBatches;
+	
+	uint16 NextTraceBatchID {0};
+
+	/** The position of this distributor in the spawn point table. */
+	int32 SpawnPointCursor {INDEX_NONE};
+
+	FTraceDelegate AsyncTraceDelegate;
 
 public:
-	void Activate(UObject* WorldContextObject);
+	/** The number of scene queries this distributor issues for a single distribution, on average. This is used to estimate the trace budget of a soundscape. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Budget", Meta = (ClampMin = "0"))
+	float EstimatedTracesPerDistribution {1.0f};
+	
+	virtual void BeginDestroy() override;
+	
+	FORCEINLINE void SetListenerState(const FAmbiverseListenerState& InListenerState) { ListenerState = InListenerState; }
 	
 	UFUNCTION(BlueprintImplementableEvent, Meta = (WorldContext = "WorldContextObject"))
 	bool ExecuteDistribution(UObject* WorldContextObject, FTransform& Transform, FVector Location, UAmbiverseElement* Element);
@@ -34,8 +78,9 @@ public:
 	UFUNCTION(BlueprintCallable)
 	FVector GetPointAtDistanceAndAngleFromListener(float Distance, float Angle);
 	
-	/** Performs a line trace downwards from the listener's location, and sets the passed FVector& to the hit location.
-	 * @param Location A reference to an FVector which will be set to the hit location.
+	/** Sets the height of the passed FVector& to the floor height at its location.
+	 *	The floor height is read from the floor cache around the listener, or traced if the cache has no data for the location.
+	 * @param Location A reference to an FVector which will be set to the floor location.
 	 * @param Offset A float value that represents the distance above the floor. */
 	UFUNCTION(BlueprintCallable, Category = "Ambiverse", Meta = (AutoCreateRefTerm = "Location"))
 	void SnapToFloor(UPARAM(ref) FVector& Location, float Offset);
@@ -46,10 +91,46 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Ambiverse", Meta = (AutoCreateRefTerm = "Location"))
 	void SetLocationByTrace(UPARAM(ref) FVector& Location, float Offset);
 
+	/** Performs a vertical line trace for every candidate point in a single call.
+	 * @param Candidates The points to trace. Each point is traced from TraceHalfHeight above to TraceHalfHeight below itself.
+	 * @param HitResults Receives a hit result for every candidate, in the same order as the candidates.
+	 *	With FirstValid selection, the candidates after the selected one are not traced and keep an empty hit result.
+	 * @param Selection How to select a candidate from the traced results.
+	 * @param TraceHalfHeight Half the length of the vertical trace.
+	 * @return The index of the selected candidate, or INDEX_NONE if no candidate was selected. */
+	UFUNCTION(BlueprintCallable, Category = "Ambiverse")
+	int32 TraceCandidates(const TArray<FVector>& Candidates, TArray<FHitResult>& HitResults,
+		EAmbiverseCandidateSelection Selection = EAmbiverseCandidateSelection::FirstValid, float TraceHalfHeight = 1000.0f);
+
+	/** Issues a vertical line trace for every candidate point as one batch of asynchronous trace requests.
+	 *	The results are delivered through OnCompleted once all traces in the batch have finished, usually in the next frame.
+	 * @return True if the batch was issued. */
+	UFUNCTION(BlueprintCallable, Category = "Ambiverse")
+	bool TraceCandidatesAsync(const TArray<FVector>& Candidates, const FOnAmbiverseCandidatesTraced& OnCompleted,
+		EAmbiverseCandidateSelection Selection = EAmbiverseCandidateSelection::FirstValid, float TraceHalfHeight = 1000.0f);
+
+	/** Returns a score for a traced candidate. Candidates with a higher score are preferred when using BestScored selection.
+	 *	By default, flat surfaces at a height close to the listener are preferred. */
+	UFUNCTION(BlueprintNativeEvent, Category = "Ambiverse")
+	float ScoreCandidate(const FHitResult& HitResult);
+
 protected:
 	UFUNCTION(BlueprintPure, Meta = (CompactNodeTitle = "Listener"))
-	FORCEINLINE AActor* GetListener() { return Listener; }
+	FORCEINLINE AActor* GetListener() { return ListenerState.ViewTarget.Get(); }
+
+	UFUNCTION(BlueprintPure, Meta = (CompactNodeTitle = "Listener State"))
+	FORCEINLINE FAmbiverseListenerState GetListenerState() const { return ListenerState; }
 
 private:
 	UWorld* GetWorldFromListener();
+
+	/** Adds scene queries issued by this distributor to the frame counters of the subsystem. */
+	void CountTraces(const int32 TraceCount) const;
+
+	int32 SelectCandidate(const TArray<FHitResult>& HitResults, const EAmbiverseCandidateSelection Selection);
+
+	void HandleAsyncTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/** Expires pending batches that have waited longer than the timeout. Their callbacks are never executed. */
+	void ExpireTraceBatches();
 };
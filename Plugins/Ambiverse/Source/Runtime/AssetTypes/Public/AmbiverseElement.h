@@ -9,6 +9,35 @@
 #include "AmbiverseElement.generated.h"
 
 class UAmbiverseDistributor;
+class UAmbiverseParameter;
+class USoundWave;
+struct FAudioParameter;
+
+/** How an element is played. */
+UENUM(BlueprintType)
+enum class EAmbiverseElementType : uint8
+{
+	OneShot		UMETA(DisplayName = "One Shot", ToolTip = "The element is fired at random intervals, and every sound is placed around the listener."),
+	Bed			UMETA(DisplayName = "Bed", ToolTip = "The element plays a persistent looping sound while its layer is active, and crossfades between its sounds.")
+};
+
+/** Forwards the value of an Ambiverse parameter to an input of the MetaSounds of an element while they play. */
+USTRUCT(BlueprintType)
+struct FAmbiverseParameterForwarding
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	UAmbiverseParameter* Parameter {nullptr};
+
+	/** The name of the float input on the MetaSound. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	FName InputName;
+
+	/** If enabled, the normalized value from 0 to 1 is forwarded instead of the value in the range of the parameter. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	bool UseNormalizedValue {false};
+};
 
 /** An ambiverse element is a single procedural sound. It can be played directly, or used in a layer to create a procedural soundscape. */
 UCLASS(Blueprintable, BlueprintType, ClassGroup = "Ambiverse", Meta = (DisplayName = "Ambiverse Element",
@@ -25,6 +54,20 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sounds")
 	TMap<UMetaSoundSource*, int> Sounds;
 
+	/** How this element is played. Beds ignore the interval and distribution settings. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Playback")
+	EAmbiverseElementType ElementType {EAmbiverseElementType::OneShot};
+
+	/** The time in seconds between crossfades to another sound of the bed. Zero keeps playing the same sound. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Playback", Meta = (ClampMin = "0", Units = "Seconds",
+		EditCondition = "ElementType == EAmbiverseElementType::Bed", EditConditionHides))
+	float BedCrossfadeInterval {30.0f};
+
+	/** The duration in seconds of a crossfade between two sounds of the bed. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Playback", Meta = (ClampMin = "0", Units = "Seconds",
+		EditCondition = "ElementType == EAmbiverseElementType::Bed", EditConditionHides))
+	float BedCrossfadeDuration {4.0f};
+
 	/** The volume multiplier for an AmbienceSystem preset entry */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sound Data",
 		Meta = (ClampMin = "0"))
@@ -38,15 +81,41 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Distribution", Meta = (EditCondition = "DistributorClass == nullptr"))
 	FAmbiverseSoundDistributionData DistributionData;
 
+	/** Parameters that are forwarded to the inputs of the sounds of this element. Changed values are sent to playing sounds once per tick. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sound Data")
+	TArray<FAmbiverseParameterForwarding> ForwardedParameters;
+
+	/** A MetaSound that renders distant instances of this element through shared, panned voices instead of individual sound sources.
+	 *	The MetaSound plays its own sounds when triggered, see UAmbiverseFarFieldManager for the inputs it is expected to expose. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Far Field", Meta = (EditCondition = "ElementType == EAmbiverseElementType::OneShot"))
+	UMetaSoundSource* FarFieldSource {nullptr};
+
+	/** The wave the far field source plays for each sound of this element. Sounds without a wave are always played by regular sound sources. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Far Field", Meta = (EditCondition = "FarFieldSource != nullptr && ElementType == EAmbiverseElementType::OneShot"))
+	TMap<UMetaSoundSource*, USoundWave*> FarFieldWaves;
+
+	/** The distance to the listener beyond which instances of this element are rendered by the far field source. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Far Field", Meta = (ClampMin = "0", Units = "Centimeters",
+		EditCondition = "FarFieldSource != nullptr && ElementType == EAmbiverseElementType::OneShot"))
+	float FarFieldDistance {5000.0f};
+
 	/** The SoundSource class to use to for this element. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sound Source")
 	TSubclassOf<AAmbiverseSoundSource> SoundSourceClass {AAmbiverseSoundSource::StaticClass()};
 	
 	bool IsValid {true};
+
+	FORCEINLINE bool IsBed() const { return ElementType == EAmbiverseElementType::Bed; }
 	
 	static UMetaSoundSource* GetSoundFromMap(const TMap<UMetaSoundSource*, int>& SoundMap);
 
+	/** Adds the current values of the forwarded parameters to an array of audio parameters.
+	 *	If an array of changed parameters is provided, only the forwarded parameters that changed are added. */
+	void GetForwardedParameters(TArray<FAudioParameter>& OutAudioParameters, const TArray<UAmbiverseParameter*>* ChangedParameters = nullptr) const;
+
 #if WITH_EDITOR
 	void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent);
+
+	virtual EDataValidationResult IsDataValid(TArray<FText>& ValidationErrors) override;
 #endif
 };
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "AmbiverseCompiledLayer.h"
 #include "AmbiverseParameter.h"
 #include "AmbiverseProceduralElement.h"
 #include "TimerManager.h"
@@ -54,6 +55,15 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Settings", Meta = (DisplayName = "Enable Layer"))
 	bool IsEnabled {true};
 
+	/** How much the density of this layer follows the distance travelled by the listener instead of the elapsed time.
+	 *	At 0, elements are scheduled by time only. At 1, elements are scheduled by distance only, and a stationary listener hears no new sounds. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Distance", Meta = (ClampMin = "0", ClampMax = "1"))
+	float DistanceDensityWeight {0.0f};
+
+	/** The listener speed, in centimeters per second, at which distance based scheduling matches time based scheduling. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Distance", Meta = (EditCondition = "DistanceDensityWeight > 0", ClampMin = "1"))
+	float ReferenceSpeed {1000.0f};
+
 	/** If true, the layer has a finite lifetime and will expire when this duration is reached after becoming active. */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Lifetime")
 	bool EnableLifetime {false};
@@ -61,8 +71,27 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Lifetime", Meta = (EditCondition = "EnableLifetime", ClampMin = "0"))
 	float Lifetime {30.0f};
 
+	/** The lifetime ratio at which the layer starts to fade out. The fade is complete when the layer expires. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Lifetime", Meta = (EditCondition = "EnableLifetime", ClampMin = "0", ClampMax = "1"))
+	float FadeStartRatio {0.8f};
+
+	/** If true, the density of the layer fades out towards the end of its lifetime. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Lifetime", Meta = (EditCondition = "EnableLifetime"))
+	bool FadeDensity {true};
+
+	/** If true, the volume of new sounds fades out towards the end of its lifetime. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Lifetime", Meta = (EditCondition = "EnableLifetime"))
+	bool FadeVolume {true};
+
+	/** The duration over which sounds that are still playing fade out when the layer expires. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Lifetime", Meta = (EditCondition = "EnableLifetime", ClampMin = "0"))
+	float ExpiryFadeOutDuration {1.0f};
+
 	float ActiveDuration {0.0f};
 
+	/** The crossfade multiplier while the layer is faded in or out by a composite transition. Scales the rate at which elements advance and the volume of new sounds. */
+	float TransitionFade {1.0f};
+
 	/** @brief The normalized ratio of the active duration of the layer relative to its maximum lifetime.
 	* This property provides a normalized value indicating how much of the layer's total lifetime has been used up.
 	* It is calculated as the active duration divided by the total lifetime. 
@@ -74,8 +103,27 @@ public:
 	
 	FTimerDelegate TimerDelegate;
 
+private:
+	/** A flattened copy of the elements and parameter modifiers. It is built when the layer is cooked, so cooked layers can be registered without compiling. */
+	UPROPERTY()
+	FAmbiverseCompiledLayer CompiledLayer;
+
+public:
+	/** Removes elements without an element asset and rebuilds the compiled layer. */
+	void Compile();
+
+	/** Returns the fade out multiplier based on the lifetime ratio. This is 1 for layers without a lifetime. */
+	float GetLifetimeFade() const;
+
+	FORCEINLINE float GetLifetimeDensityScalar() const { return FadeDensity ? GetLifetimeFade() : 1.0f; }
+	FORCEINLINE float GetLifetimeVolumeScalar() const { return FadeVolume ? GetLifetimeFade() : 1.0f; }
+	
+	FORCEINLINE const FAmbiverseCompiledLayer& GetCompiledLayer() const { return CompiledLayer; }
+
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
+
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
 #endif
 };
 
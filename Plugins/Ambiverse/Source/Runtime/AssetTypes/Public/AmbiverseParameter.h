@@ -3,8 +3,18 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Curves/CurveFloat.h"
 #include "AmbiverseParameter.generated.h"
 
+/** How the value of a parameter follows the values that are set on it. */
+UENUM(BlueprintType)
+enum class EAmbiverseParameterSmoothing : uint8
+{
+	None				UMETA(DisplayName = "None", ToolTip = "Values are applied immediately."),
+	Slew				UMETA(DisplayName = "Slew", ToolTip = "The value moves towards the target at a constant rate."),
+	CriticallyDamped	UMETA(DisplayName = "Critically Damped", ToolTip = "The value eases towards the target like a critically damped spring, without overshooting.")
+};
+
 /** An ambiverse layer is an instanced parameter that can be set through the ParameterManager in the AmbiverseSubsystem.
  *	Users can link modifiers to a parameter to change the density and volume of procedural sounds. */
 UCLASS(Blueprintable, BlueprintType, ClassGroup = "Ambiverse", Meta = (DisplayName = "Ambiverse Parameter",
@@ -22,12 +32,36 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Parameter", Meta = (DisplayName = "Default Value"))
 	float DefaultValue {0.0f};
 
+	/** How the value of this parameter follows the values that are set on it. Smoothed parameters are integrated once per tick by the ParameterManager. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Smoothing")
+	EAmbiverseParameterSmoothing Smoothing {EAmbiverseParameterSmoothing::None};
+
+	/** The maximum rate of change, as a fraction of the value range per second. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Smoothing", Meta = (ClampMin = "0.01", UIMin = "0.01", UIMax = "10",
+		EditCondition = "Smoothing == EAmbiverseParameterSmoothing::Slew", EditConditionHides))
+	float SlewRate {1.0f};
+
+	/** The approximate time in seconds it takes the value to reach its target. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Smoothing", Meta = (ClampMin = "0.01", UIMin = "0.01", UIMax = "10", Units = "Seconds",
+		EditCondition = "Smoothing == EAmbiverseParameterSmoothing::CriticallyDamped", EditConditionHides))
+	float SmoothingTime {0.25f};
+
 	/** The normalized scaled value of this parameter. */
-	float ParameterValue;
+	float ParameterValue {0.0f};
 
 public:
 	float SetParameter(float Value);
 
+	/** Returns the current value in the value range of this parameter. */
+	float GetValue() const;
+
+	/** Returns a value mapped from the value range of this parameter to its normalized range. */
+	float GetNormalizedValue(const float Value) const;
+
+	/** Moves a normalized value towards a normalized target using the smoothing of this parameter.
+	 *	@param Velocity The rate of change of the value, carried over between calls for critically damped smoothing. */
+	float SmoothValue(const float Value, const float Target, float& Velocity, const float DeltaTime) const;
+
 private:
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
@@ -35,16 +69,36 @@ private:
 };
 
 USTRUCT(BlueprintType)
-struct FAmbiverseParameterModifiers
+struct AMBIVERSE_API FAmbiverseParameterModifiers
 {
 	GENERATED_USTRUCT_BODY()
 	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	UAmbiverseParameter* Parameter {nullptr};
 
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Meta = (ClampMin = "0", ClampMax = "2", UIMin = "0", UIMax = "2"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Meta = (ClampMin = "0", ClampMax = "2", UIMin = "0", UIMax = "2", EditCondition = "!UseCurves"))
 	FVector2D VolumeRange {FVector2D(1, 1)};
 
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Meta = (ClampMin = "0", ClampMax = "10", UIMin = "0", UIMax = "10"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Meta = (ClampMin = "0", ClampMax = "10", UIMin = "0", UIMax = "10", EditCondition = "!UseCurves"))
 	FVector2D DensityRange {FVector2D(1, 1)};
+
+	/** If enabled, the volume and density follow curves instead of their linear ranges. 
+	 *	The curves map the normalized parameter value from 0 to 1 onto a multiplier, and are baked into lookup tables when the layer is compiled. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Meta = (InlineEditConditionToggle))
+	bool UseCurves {false};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Meta = (EditCondition = "UseCurves", XAxisName = "Parameter", YAxisName = "Volume"))
+	FRuntimeFloatCurve VolumeCurve;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Meta = (EditCondition = "UseCurves", XAxisName = "Parameter", YAxisName = "Density"))
+	FRuntimeFloatCurve DensityCurve;
+
+	/** Returns the volume multiplier at a normalized parameter value. */
+	float GetVolume(const float Alpha) const;
+
+	/** Returns the density multiplier at a normalized parameter value. */
+	float GetDensity(const float Alpha) const;
+
+	/** Returns the highest density multiplier over the normalized parameter range. */
+	float GetMaxDensity() const;
 };
@@ -1,17 +1,30 @@
 // Copyright (c) 2023-present Tim Verberne. All rights reserved.
 
 #include "Ambiverse.h"
+#include "AmbiverseTrace.h"
+
+#if AMBIVERSE_TRACE_ENABLED
+#include "ProfilingDebugging/TraceAuxiliary.h"
+#endif
 
 #define LOCTEXT_NAMESPACE "FAmbiverseModule"
 
 void FAmbiverseModule::StartupModule()
 {
-	
+#if AMBIVERSE_TRACE_ENABLED
+	/** A new trace session does not contain the names sent to a previous one. */
+	TraceStartedHandle = FTraceAuxiliary::OnTraceStarted.AddLambda([](FTraceAuxiliary::EConnectionType, const FString&)
+	{
+		FAmbiverseTrace::ResetOutputNames();
+	});
+#endif
 }
 
 void FAmbiverseModule::ShutdownModule()
 {
-	
+#if AMBIVERSE_TRACE_ENABLED
+	FTraceAuxiliary::OnTraceStarted.Remove(TraceStartedHandle);
+#endif
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -11,7 +11,7 @@ UAmbiverseBPLibrary::UAmbiverseBPLibrary(const FObjectInitializer& ObjectInitial
 {
 }
 
-void UAmbiverseBPLibrary::AddAmbiverseLayer(UObject* WorldContextObject, UAmbiverseLayer* AmbiverseLayer)
+void UAmbiverseBPLibrary::AddAmbiverseLayer(UObject* WorldContextObject, UAmbiverseLayer* AmbiverseLayer, const int32 OwningListenerIndex)
 {
 	if (!WorldContextObject) { return; }
 
@@ -21,7 +21,7 @@ void UAmbiverseBPLibrary::AddAmbiverseLayer(UObject* WorldContextObject, UAmbive
 		{
 			if (UAmbiverseLayerManager* LayerManager {AmbiverseSubsystem->GetLayerManager()})
 			{
-				LayerManager->RegisterAmbiverseLayer(AmbiverseLayer);
+				LayerManager->RegisterAmbiverseLayer(AmbiverseLayer, OwningListenerIndex);
 			}
 		}
 	}
@@ -43,6 +43,38 @@ void UAmbiverseBPLibrary::PopAmbiverseLayer(UObject* WorldContextObject, UAmbive
 	}
 }
 
+void UAmbiverseBPLibrary::PushAmbiverseComposite(UObject* WorldContextObject, UAmbiverseComposite* AmbiverseComposite)
+{
+	if (!WorldContextObject) { return; }
+
+	if (UWorld* World {WorldContextObject->GetWorld()})
+	{
+		if (UAmbiverseSubsystem* AmbiverseSubsystem {World->GetSubsystem<UAmbiverseSubsystem>()})
+		{
+			if (UAmbiverseLayerManager* LayerManager {AmbiverseSubsystem->GetLayerManager()})
+			{
+				LayerManager->PushComposite(AmbiverseComposite);
+			}
+		}
+	}
+}
+
+void UAmbiverseBPLibrary::PopAmbiverseComposite(UObject* WorldContextObject)
+{
+	if (!WorldContextObject) { return; }
+
+	if (UWorld* World {WorldContextObject->GetWorld()})
+	{
+		if (UAmbiverseSubsystem* AmbiverseSubsystem {World->GetSubsystem<UAmbiverseSubsystem>()})
+		{
+			if (UAmbiverseLayerManager* LayerManager {AmbiverseSubsystem->GetLayerManager()})
+			{
+				LayerManager->PopComposite();
+			}
+		}
+	}
+}
+
 void UAmbiverseBPLibrary::SetAmbiverseParameter(UObject* WorldContextObject, UAmbiverseParameter* AmbiverseParameter, const float Value)
 {
 	if (!WorldContextObject) { return; }
@@ -58,3 +90,36 @@ void UAmbiverseBPLibrary::SetAmbiverseParameter(UObject* WorldContextObject, UAm
 		}
 	}
 }
+
+FAmbiverseParameterHandle UAmbiverseBPLibrary::GetAmbiverseParameterHandle(UObject* WorldContextObject, UAmbiverseParameter* AmbiverseParameter)
+{
+	if (!WorldContextObject) { return FAmbiverseParameterHandle(); }
+
+	if (UWorld* World {WorldContextObject->GetWorld()})
+	{
+		if (UAmbiverseSubsystem* AmbiverseSubsystem {World->GetSubsystem<UAmbiverseSubsystem>()})
+		{
+			if (UAmbiverseParameterManager* ParameterManager {AmbiverseSubsystem->GetParameterManager()})
+			{
+				return ParameterManager->GetParameterHandle(AmbiverseParameter);
+			}
+		}
+	}
+	return FAmbiverseParameterHandle();
+}
+
+void UAmbiverseBPLibrary::SetAmbiverseParameters(UObject* WorldContextObject, const TArray<FAmbiverseParameterHandle>& Handles, const TArray<float>& Values)
+{
+	if (!WorldContextObject) { return; }
+
+	if (UWorld* World {WorldContextObject->GetWorld()})
+	{
+		if (UAmbiverseSubsystem* AmbiverseSubsystem {World->GetSubsystem<UAmbiverseSubsystem>()})
+		{
+			if (UAmbiverseParameterManager* ParameterManager {AmbiverseSubsystem->GetParameterManager()})
+			{
+				ParameterManager->SetParameters(Handles, Values);
+			}
+		}
+	}
+}
@@ -0,0 +1,278 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseBedManager.h"
+#include "AmbiverseLayer.h"
+#include "AmbiverseLayerManager.h"
+#include "AmbiverseParameterManager.h"
+#include "AmbiverseSubsystem.h"
+#include "AmbiverseTrace.h"
+#include "AudioParameter.h"
+#include "Components/AudioComponent.h"
+#include "Kismet/GameplayStatics.h"
+
+DEFINE_LOG_CATEGORY_CLASS(UAmbiverseBedManager, LogAmbiverseBedManager);
+
+void UAmbiverseBedManager::Initialize(UAmbiverseSubsystem* Subsystem)
+{
+	Super::Initialize(Subsystem);
+
+	if (UAmbiverseLayerManager* LayerManager {Subsystem->GetLayerManager()})
+	{
+		LayerManager->OnLayerRegistered.AddDynamic(this, &UAmbiverseBedManager::HandleOnLayerRegistered);
+		LayerManager->OnLayerUnregistered.AddDynamic(this, &UAmbiverseBedManager::HandleOnLayerUnregistered);
+	}
+}
+
+void UAmbiverseBedManager::Tick(const float DeltaTime)
+{
+	if (!Owner || Beds.IsEmpty()) { return; }
+
+	AMBIVERSE_TRACE_SCOPE(AmbiverseUpdateBeds);
+
+	const UAmbiverseParameterManager* ParameterManager {Owner->GetParameterManager()};
+	const TArray<UAmbiverseParameter*>* ChangedParameters {ParameterManager ? &ParameterManager->GetChangedParameters() : nullptr};
+
+	for (FAmbiverseBed& Bed : Beds)
+	{
+		if (!Bed.Layer || !Bed.Layer->ProceduralElements.IsValidIndex(Bed.ElementIndex)) { continue; }
+		
+		const UAmbiverseElement* Element {Bed.Layer->ProceduralElements[Bed.ElementIndex].Element};
+		if (!Element) { continue; }
+
+		/** Both voices receive the changed parameters, so a voice that is fading out doesn't jump when it is audible again.
+		 *	They are forwarded before any crossfade, so the voice that starts fading out on this tick receives them as well. */
+		if (ChangedParameters && !ChangedParameters->IsEmpty() && !Element->ForwardedParameters.IsEmpty())
+		{
+			ForwardParameters(Bed, ChangedParameters);
+		}
+
+		/** A sound of unknown duration that does not loop by itself is only replaced once it has finished, so the next sound fades in.
+		 *	If no voice could be created, the bed waits for its next crossfade instead of retrying every tick. */
+		const UAudioComponent* ActiveVoice {Bed.Voices[Bed.ActiveVoice]};
+		if (ActiveVoice && (!IsValid(ActiveVoice) || !ActiveVoice->IsPlaying()))
+		{
+			Bed.Voices[Bed.ActiveVoice] = nullptr;
+			CrossfadeBed(Bed, Element->BedCrossfadeDuration);
+		}
+		else
+		{
+			Bed.TimeUntilCrossfade -= DeltaTime;
+			if (Bed.TimeUntilCrossfade <= 0.0f)
+			{
+				CrossfadeBed(Bed, Bed.CrossfadeDuration);
+			}
+		}
+
+		const float Volume {GetBedVolume(Bed)};
+		if (FMath::IsNearlyEqual(Volume, Bed.Volume, 0.005f)) { continue; }
+
+		Bed.Volume = Volume;
+		for (UAudioComponent* Voice : Bed.Voices)
+		{
+			if (IsValid(Voice))
+			{
+				Voice->SetVolumeMultiplier(Volume);
+			}
+		}
+	}
+}
+
+void UAmbiverseBedManager::HandleOnLayerRegistered(UAmbiverseLayer* RegisteredLayer)
+{
+	if (!RegisteredLayer || !Owner || Owner->IsSimulationMode()) { return; }
+
+	for (int32 ElementIndex {0}; ElementIndex < RegisteredLayer->ProceduralElements.Num(); ++ElementIndex)
+	{
+		const UAmbiverseElement* Element {RegisteredLayer->ProceduralElements[ElementIndex].Element};
+		if (!Element || !Element->IsBed()) { continue; }
+
+		FAmbiverseBed& Bed {Beds.AddDefaulted_GetRef()};
+		Bed.Layer = RegisteredLayer;
+		Bed.ElementIndex = ElementIndex;
+
+		/** The first sound fades in, so a bed that starts along with a crossfading layer doesn't pop in. */
+		CrossfadeBed(Bed, Element->BedCrossfadeDuration);
+		
+		UE_LOG(LogAmbiverseBedManager, Verbose, TEXT("HandleOnLayerRegistered: Started bed '%s' of layer '%s'."),
+			*Element->GetName(), *RegisteredLayer->GetName());
+	}
+}
+
+void UAmbiverseBedManager::HandleOnLayerUnregistered(UAmbiverseLayer* UnregisteredLayer)
+{
+	if (!UnregisteredLayer) { return; }
+
+	for (int32 Index {Beds.Num() - 1}; Index >= 0; --Index)
+	{
+		if (Beds[Index].Layer != UnregisteredLayer) { continue; }
+
+		StopBed(Beds[Index], UnregisteredLayer->ExpiryFadeOutDuration);
+		Beds.RemoveAtSwap(Index);
+	}
+}
+
+void UAmbiverseBedManager::CrossfadeBed(FAmbiverseBed& Bed, const float FadeDuration)
+{
+	const FAmbiverseProceduralElement& ProceduralElement {Bed.Layer->ProceduralElements[Bed.ElementIndex]};
+	const UAmbiverseElement* Element {ProceduralElement.Element};
+	
+	Bed.TimeUntilCrossfade = Element->BedCrossfadeInterval > 0.0f ? Element->BedCrossfadeInterval : TNumericLimits<float>::Max();
+	Bed.CrossfadeDuration = Element->BedCrossfadeDuration;
+
+	/** Sounds are selected from the compiled layer like fired elements. A second draw avoids most repetitions of the same sound. */
+	UMetaSoundSource* Sound {nullptr};
+	const FAmbiverseCompiledLayer& CompiledLayer {Bed.Layer->GetCompiledLayer()};
+	if (CompiledLayer.GetIsCompiled())
+	{
+		const UAudioComponent* PreviousVoice {Bed.Voices[Bed.ActiveVoice]};
+		Sound = CompiledLayer.SelectSound(Bed.ElementIndex, Owner->GetRandomStream());
+		if (IsValid(PreviousVoice) && PreviousVoice->Sound == Sound)
+		{
+			Sound = CompiledLayer.SelectSound(Bed.ElementIndex, Owner->GetRandomStream());
+		}
+	}
+	else
+	{
+		Sound = UAmbiverseElement::GetSoundFromMap(Element->Sounds);
+	}
+	
+	if (!Sound) { return; }
+
+	/** The inactive voice may still be fading out from the previous crossfade. It is cut, so the bed never uses more than two voices. */
+	const int32 NextVoice {1 - Bed.ActiveVoice};
+	if (IsValid(Bed.Voices[NextVoice]))
+	{
+		Bed.Voices[NextVoice]->Stop();
+	}
+
+	Bed.Volume = GetBedVolume(Bed);
+	UAudioComponent* Voice {UGameplayStatics::CreateSound2D(Owner, Sound, Bed.Volume)};
+	Bed.Voices[NextVoice] = Voice;
+	
+	if (!Voice)
+	{
+		UE_LOG(LogAmbiverseBedManager, Verbose, TEXT("CrossfadeBed: Unable to create a voice for '%s'."), *Element->GetName());
+		return;
+	}
+
+	/** A sound of known duration that does not loop by itself is crossfaded ahead of its end, so the next sound overlaps it instead of following a gap.
+	 *	Short sounds overlap by at most half their duration, so a bed never crossfades on every tick. */
+	const float SoundDuration {Sound->GetDuration()};
+	if (!Sound->IsLooping() && SoundDuration > 0.0f)
+	{
+		Bed.CrossfadeDuration = FMath::Min(Bed.CrossfadeDuration, SoundDuration * 0.5f);
+		Bed.TimeUntilCrossfade = FMath::Min(Bed.TimeUntilCrossfade, SoundDuration - Bed.CrossfadeDuration);
+	}
+
+	/** The parameters are set before the voice starts, so its first block already uses the current values. */
+	TArray<FAudioParameter> AudioParameters;
+	Element->GetForwardedParameters(AudioParameters);
+	if (!AudioParameters.IsEmpty())
+	{
+		Voice->SetParameters(MoveTemp(AudioParameters));
+	}
+
+	if (FadeDuration > 0.0f)
+	{
+		Voice->FadeIn(FadeDuration);
+		if (IsValid(Bed.Voices[Bed.ActiveVoice]))
+		{
+			Bed.Voices[Bed.ActiveVoice]->FadeOut(FadeDuration, 0.0f);
+		}
+	}
+	else
+	{
+		Voice->Play();
+		if (IsValid(Bed.Voices[Bed.ActiveVoice]))
+		{
+			Bed.Voices[Bed.ActiveVoice]->Stop();
+		}
+	}
+
+	Bed.ActiveVoice = NextVoice;
+}
+
+float UAmbiverseBedManager::GetBedVolume(const FAmbiverseBed& Bed) const
+{
+	const FAmbiverseProceduralElement& ProceduralElement {Bed.Layer->ProceduralElements[Bed.ElementIndex]};
+	
+	float DensityScalar {1.0f};
+	float VolumeScalar {1.0f};
+	
+	if (UAmbiverseParameterManager* ParameterManager {Owner->GetParameterManager()})
+	{
+		ParameterManager->GetScalarsForElement(DensityScalar, VolumeScalar, Bed.Layer, Bed.ElementIndex);
+	}
+	
+	return ProceduralElement.Element->Volume * VolumeScalar * Bed.Layer->GetLifetimeVolumeScalar() * Bed.Layer->TransitionFade;
+}
+
+void UAmbiverseBedManager::ForwardParameters(const FAmbiverseBed& Bed, const TArray<UAmbiverseParameter*>* ChangedParameters)
+{
+	const UAmbiverseElement* Element {Bed.Layer->ProceduralElements[Bed.ElementIndex].Element};
+	
+	TArray<FAudioParameter> AudioParameters;
+	Element->GetForwardedParameters(AudioParameters, ChangedParameters);
+	if (AudioParameters.IsEmpty()) { return; }
+
+	for (UAudioComponent* Voice : Bed.Voices)
+	{
+		if (IsValid(Voice))
+		{
+			Voice->SetParameters(CopyTemp(AudioParameters));
+		}
+	}
+}
+
+void UAmbiverseBedManager::StopBed(FAmbiverseBed& Bed, const float FadeOutDuration)
+{
+	for (UAudioComponent*& Voice : Bed.Voices)
+	{
+		if (!IsValid(Voice)) { continue; }
+		
+		if (FadeOutDuration > 0.0f)
+		{
+			Voice->FadeOut(FadeOutDuration, 0.0f);
+		}
+		else
+		{
+			Voice->Stop();
+		}
+		Voice = nullptr;
+	}
+}
+
+int32 UAmbiverseBedManager::GetBedVoiceCount() const
+{
+	int32 VoiceCount {0};
+	for (const FAmbiverseBed& Bed : Beds)
+	{
+		for (const UAudioComponent* Voice : Bed.Voices)
+		{
+			if (IsValid(Voice) && Voice->IsPlaying())
+			{
+				++VoiceCount;
+			}
+		}
+	}
+	return VoiceCount;
+}
+
+void UAmbiverseBedManager::Deinitialize(UAmbiverseSubsystem* Subsystem)
+{
+	if (!Subsystem) { return; }
+
+	for (FAmbiverseBed& Bed : Beds)
+	{
+		StopBed(Bed, 0.0f);
+	}
+	Beds.Empty();
+	
+	if (UAmbiverseLayerManager* LayerManager {Subsystem->GetLayerManager()})
+	{
+		LayerManager->OnLayerRegistered.RemoveDynamic(this, &UAmbiverseBedManager::HandleOnLayerRegistered);
+		LayerManager->OnLayerUnregistered.RemoveDynamic(this, &UAmbiverseBedManager::HandleOnLayerUnregistered);
+	}
+
+	Super::Deinitialize(Subsystem);
+}
@@ -6,13 +6,70 @@
 
 DEFINE_LOG_CATEGORY_CLASS(UAmbiverseDistributorManager, LogAmbiverseDistributorManager);
 
+static TAutoConsoleVariable<int32> CVarFloorCacheResolution(
+	TEXT("av.FloorCache.Resolution"), 16,
+	TEXT("The number of cells along each axis of the floor height cache around the listener."));
+
+static TAutoConsoleVariable<float> CVarFloorCacheCellSize(
+	TEXT("av.FloorCache.CellSize"), 500.0f,
+	TEXT("The size of a single cell of the floor height cache, in centimeters."));
+
+static TAutoConsoleVariable<float> CVarFloorCacheTraceHalfHeight(
+	TEXT("av.FloorCache.TraceHalfHeight"), 5000.0f,
+	TEXT("Half the length of the downward traces used to fill the floor height cache, in centimeters."));
+
+static TAutoConsoleVariable<int32> CVarFloorCacheMaxTracesPerTick(
+	TEXT("av.FloorCache.MaxTracesPerTick"), 16,
+	TEXT("The maximum number of traces the floor height cache issues per tick."));
+
+void UAmbiverseDistributorManager::Initialize(UAmbiverseSubsystem* Subsystem)
+{
+	Super::Initialize(Subsystem);
+
+	FloorCache.Initialize(this, CVarFloorCacheResolution.GetValueOnGameThread(), CVarFloorCacheCellSize.GetValueOnGameThread(),
+		CVarFloorCacheTraceHalfHeight.GetValueOnGameThread());
+
+	Subsystem->OnListenerViewTargetChanged.AddDynamic(this, &UAmbiverseDistributorManager::HandleOnListenerViewTargetChanged);
+}
+
+void UAmbiverseDistributorManager::Deinitialize(UAmbiverseSubsystem* Subsystem)
+{
+	if (!Subsystem) { return; }
+
+	Subsystem->OnListenerViewTargetChanged.RemoveDynamic(this, &UAmbiverseDistributorManager::HandleOnListenerViewTargetChanged);
+	
+	Super::Deinitialize(Subsystem);
+}
+
+void UAmbiverseDistributorManager::Tick(const float DeltaTime)
+{
+	if (!Owner || Distributors.IsEmpty()) { return; }
+
+	const FAmbiverseListenerState& Listener {Owner->GetListenerState()};
+	if (!Listener.IsValid) { return; }
+	
+	for (UAmbiverseDistributor* Distributor : Distributors)
+	{
+		Distributor->SetListenerState(Listener);
+	}
+
+	Owner->GetFrameCounters().Traces += FloorCache.Update(Owner->GetWorld(), Listener.Location, Listener.ViewTarget.Get(),
+		CVarFloorCacheMaxTracesPerTick.GetValueOnGameThread());
+}
+
+void UAmbiverseDistributorManager::HandleOnListenerViewTargetChanged(AActor* ViewTarget)
+{
+	/** The floor below a new view target can be unrelated to the floor below the previous one. */
+	FloorCache.Invalidate();
+}
+
 UAmbiverseDistributor* UAmbiverseDistributorManager::GetDistributorByClass(TSubclassOf<UAmbiverseDistributor> Class)
 {
 	if (!Owner) { return nullptr ; }
 	
 	for (UAmbiverseDistributor* Distributor : Distributors)
 	{
-		if (Distributor->StaticClass() == Class)
+		if (Distributor->GetClass() == Class)
 		{
 			UE_LOG(LogAmbiverseDistributorManager, VeryVerbose, TEXT("GetDistributorByClass: Found existing distributor of class: %s"), *Class->GetName());
 			return Distributor;
@@ -25,7 +82,8 @@ UAmbiverseDistributor* UAmbiverseDistributorManager::GetDistributorByClass(TSubc
 
 	if (Distributor)
 	{
-		Distributor->Activate(Owner);
+		Distributor->SetListenerState(Owner->GetListenerState());
+		Distributors.Add(Distributor);
 	}
 	
 	return Distributor;
@@ -0,0 +1,259 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseFarFieldManager.h"
+#include "AmbiverseElement.h"
+#include "AmbiverseLayer.h"
+#include "AmbiverseLayerManager.h"
+#include "AmbiverseListenerState.h"
+#include "AmbiverseSoundSourceData.h"
+#include "AmbiverseSubsystem.h"
+#include "AmbiverseTrace.h"
+#include "AudioParameter.h"
+#include "Components/AudioComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "MetasoundFrontendDocument.h"
+#include "MetasoundSource.h"
+#include "Sound/SoundWave.h"
+
+DEFINE_LOG_CATEGORY_CLASS(UAmbiverseFarFieldManager, LogAmbiverseFarField);
+
+static TAutoConsoleVariable<bool> CVarFarFieldEnabled(
+	TEXT("av.FarField.Enabled"), true,
+	TEXT("If enabled, distant elements with a far field source are rendered through shared voices."));
+
+static TAutoConsoleVariable<int32> CVarFarFieldMaxVoices(
+	TEXT("av.FarField.MaxVoices"), 8,
+	TEXT("The maximum number of shared far field voices. Distant elements beyond this are played by regular sound sources."));
+
+static TAutoConsoleVariable<int32> CVarFarFieldVoicesPerSource(
+	TEXT("av.FarField.VoicesPerSource"), 2,
+	TEXT("The maximum number of shared voices for a single far field source. Instances are distributed over the voices of a source."));
+
+static TAutoConsoleVariable<float> CVarFarFieldIdleTime(
+	TEXT("av.FarField.IdleTime"), 20.0f,
+	TEXT("The time in seconds after which a far field voice that has not been triggered is stopped."));
+
+static const FName FarFieldPlayInput {TEXT("Play")};
+static const FName FarFieldWaveInput {TEXT("Wave")};
+static const FName FarFieldAzimuthInput {TEXT("Azimuth")};
+static const FName FarFieldDistanceInput {TEXT("Distance")};
+static const FName FarFieldGainInput {TEXT("Gain")};
+
+/** The fade out of a voice that is released because it has not been triggered for a while. Its last instances have usually finished by then. */
+static constexpr float IdleFadeOutDuration {1.0f};
+
+void UAmbiverseFarFieldManager::Initialize(UAmbiverseSubsystem* Subsystem)
+{
+	Super::Initialize(Subsystem);
+
+	if (UAmbiverseLayerManager* LayerManager {Subsystem->GetLayerManager()})
+	{
+		LayerManager->OnLayerUnregistered.AddDynamic(this, &UAmbiverseFarFieldManager::HandleOnLayerUnregistered);
+	}
+}
+
+void UAmbiverseFarFieldManager::Tick(const float DeltaTime)
+{
+	if (!Owner || Voices.IsEmpty()) { return; }
+
+	/** Idle voices are released, so a source that is no longer fired doesn't keep its far field voices running. */
+	const double CurrentTime {Owner->GetWorld()->GetTimeSeconds()};
+	const double IdleTime {CVarFarFieldIdleTime.GetValueOnGameThread()};
+	
+	for (int32 Index {Voices.Num() - 1}; Index >= 0; --Index)
+	{
+		FAmbiverseFarFieldVoice& Voice {Voices[Index]};
+		if (!IsValid(Voice.AudioComponent) || CurrentTime - Voice.LastTriggerTime >= IdleTime)
+		{
+			ReleaseVoice(Index, IdleFadeOutDuration);
+			continue;
+		}
+
+		/** The voice follows the fades of its layer, so instances that are still sounding fade out along with a transition. */
+		const float Gain {GetLayerGain(Voice.Layer)};
+		if (FMath::IsNearlyEqual(Gain, Voice.Gain, 0.005f)) { continue; }
+
+		Voice.Gain = Gain;
+		Voice.AudioComponent->SetVolumeMultiplier(Gain);
+	}
+}
+
+bool UAmbiverseFarFieldManager::TryRenderFarField(const FAmbiverseSoundSourceData& SoundSourceData, const FAmbiverseListenerState& Listener)
+{
+	if (!Owner || !SoundSourceData.Element || !SoundSourceData.Element->FarFieldSource) { return false; }
+	if (!CVarFarFieldEnabled.GetValueOnGameThread()) { return false; }
+
+	/** Far field voices are panned relative to a single listener, so they can't be shared in split screen. */
+	if (Owner->GetListenerStates().Num() > 1) { return false; }
+
+	const FVector Offset {SoundSourceData.Transform.GetLocation() - Listener.Location};
+	const float Distance {static_cast<float>(Offset.Size())};
+	if (Distance < SoundSourceData.Element->FarFieldDistance) { return false; }
+
+	/** The far field source plays the wave of the selected sound, so a sound without a wave can't be rendered by it. */
+	USoundWave* const* Wave {SoundSourceData.Element->FarFieldWaves.Find(SoundSourceData.Sound)};
+	if (!Wave || !*Wave) { return false; }
+
+	FAmbiverseFarFieldVoice* Voice {AcquireVoice(SoundSourceData.Element->FarFieldSource, SoundSourceData.Layer)};
+	if (!Voice) { return false; }
+
+	AMBIVERSE_TRACE_SCOPE(AmbiverseRenderFarField);
+
+	const FVector LocalOffset {Listener.Rotation.UnrotateVector(Offset)};
+	const float Azimuth {FMath::RadiansToDegrees(FMath::Atan2(static_cast<float>(LocalOffset.Y), static_cast<float>(LocalOffset.X)))};
+
+	/** The inputs are sent as a single batch directly before the trigger, so the MetaSound can latch them for this instance. */
+	TArray<FAudioParameter> AudioParameters;
+	AudioParameters.Reserve(4);
+	AudioParameters.Emplace(FarFieldWaveInput, *Wave);
+	AudioParameters.Emplace(FarFieldAzimuthInput, Azimuth);
+	AudioParameters.Emplace(FarFieldDistanceInput, Distance);
+	AudioParameters.Emplace(FarFieldGainInput, SoundSourceData.Element->Volume);
+
+	UAudioComponent* AudioComponent {Voice->AudioComponent};
+	AudioComponent->SetParameters(MoveTemp(AudioParameters));
+
+	if (!AudioComponent->IsPlaying())
+	{
+		AudioComponent->Play();
+	}
+	AudioComponent->SetTriggerParameter(FarFieldPlayInput);
+
+	Voice->LastTriggerTime = Owner->GetWorld()->GetTimeSeconds();
+	return true;
+}
+
+FAmbiverseFarFieldVoice* UAmbiverseFarFieldManager::AcquireVoice(UMetaSoundSource* Source, UAmbiverseLayer* Layer)
+{
+	TArray<int32, TInlineAllocator<8>> SourceVoices;
+	for (int32 Index {0}; Index < Voices.Num(); ++Index)
+	{
+		if (Voices[Index].Source == Source && Voices[Index].Layer == Layer && IsValid(Voices[Index].AudioComponent))
+		{
+			SourceVoices.Add(Index);
+		}
+	}
+
+	const int32 MaxVoicesPerSource {FMath::Max(1, CVarFarFieldVoicesPerSource.GetValueOnGameThread())};
+	const TPair<const UMetaSoundSource*, const UAmbiverseLayer*> CursorKey {Source, Layer};
+	
+	if (SourceVoices.Num() >= MaxVoicesPerSource || (!SourceVoices.IsEmpty() && Voices.Num() >= CVarFarFieldMaxVoices.GetValueOnGameThread()))
+	{
+		int32& Cursor {VoiceCursors.FindOrAdd(CursorKey)};
+		Cursor = (Cursor + 1) % SourceVoices.Num();
+		return &Voices[SourceVoices[Cursor]];
+	}
+
+	if (Voices.Num() >= CVarFarFieldMaxVoices.GetValueOnGameThread()) { return nullptr; }
+
+	const float Gain {GetLayerGain(Layer)};
+	UAudioComponent* AudioComponent {UGameplayStatics::CreateSound2D(Owner, Source, Gain, 1.0f, 0.0f, nullptr, false, false)};
+	if (!AudioComponent) { return nullptr; }
+
+	FAmbiverseFarFieldVoice& Voice {Voices.AddDefaulted_GetRef()};
+	Voice.Source = Source;
+	Voice.Layer = Layer;
+	Voice.AudioComponent = AudioComponent;
+	Voice.Gain = Gain;
+	VoiceCursors.Add(CursorKey, SourceVoices.Num());
+	
+	UE_LOG(LogAmbiverseFarField, Verbose, TEXT("AcquireVoice: Created far field voice %d for '%s' of layer '%s'."),
+		SourceVoices.Num(), *Source->GetName(), *GetNameSafe(Layer));
+	return &Voice;
+}
+
+void UAmbiverseFarFieldManager::ReleaseVoice(const int32 Index, const float FadeOutDuration)
+{
+	const FAmbiverseFarFieldVoice Voice {Voices[Index]};
+	Voices.RemoveAtSwap(Index);
+	
+	if (IsValid(Voice.AudioComponent))
+	{
+		if (FadeOutDuration > 0.0f && Voice.AudioComponent->IsPlaying())
+		{
+			Voice.AudioComponent->bAutoDestroy = true;
+			Voice.AudioComponent->FadeOut(FadeOutDuration, 0.0f);
+		}
+		else
+		{
+			Voice.AudioComponent->Stop();
+			Voice.AudioComponent->DestroyComponent();
+		}
+	}
+	
+	UE_LOG(LogAmbiverseFarField, Verbose, TEXT("ReleaseVoice: Released far field voice for '%s' of layer '%s'."),
+		*GetNameSafe(Voice.Source), *GetNameSafe(Voice.Layer));
+
+	/** The cursor of a source is only kept while the source has voices, so sources and layers that are no longer used don't accumulate. */
+	if (!Voices.ContainsByPredicate([&Voice](const FAmbiverseFarFieldVoice& Other) { return Other.Source == Voice.Source && Other.Layer == Voice.Layer; }))
+	{
+		VoiceCursors.Remove(TPair<const UMetaSoundSource*, const UAmbiverseLayer*>(Voice.Source, Voice.Layer));
+	}
+}
+
+float UAmbiverseFarFieldManager::GetLayerGain(const UAmbiverseLayer* Layer)
+{
+	return Layer ? Layer->GetLifetimeVolumeScalar() * Layer->TransitionFade : 1.0f;
+}
+
+void UAmbiverseFarFieldManager::HandleOnLayerUnregistered(UAmbiverseLayer* UnregisteredLayer)
+{
+	if (!UnregisteredLayer) { return; }
+
+	for (int32 Index {Voices.Num() - 1}; Index >= 0; --Index)
+	{
+		if (Voices[Index].Layer != UnregisteredLayer) { continue; }
+
+		ReleaseVoice(Index, UnregisteredLayer->ExpiryFadeOutDuration);
+	}
+}
+
+#if WITH_EDITOR
+TArray<FText> UAmbiverseFarFieldManager::ValidateFarFieldSource(const UMetaSoundSource* Source)
+{
+	TArray<FText> Errors;
+	if (!Source) { return Errors; }
+
+	const TPair<FName, FName> ExpectedInputs[]
+	{
+		{FarFieldPlayInput, TEXT("Trigger")},
+		{FarFieldWaveInput, TEXT("WaveAsset")},
+		{FarFieldAzimuthInput, TEXT("Float")},
+		{FarFieldDistanceInput, TEXT("Float")},
+		{FarFieldGainInput, TEXT("Float")},
+	};
+
+	const TArray<FMetasoundFrontendClassInput>& Inputs {Source->GetDocumentChecked().RootGraph.Interface.Inputs};
+	for (const TPair<FName, FName>& ExpectedInput : ExpectedInputs)
+	{
+		const FMetasoundFrontendClassInput* Input {Inputs.FindByPredicate([&ExpectedInput](const FMetasoundFrontendClassInput& Candidate)
+		{
+			return Candidate.Name == ExpectedInput.Key;
+		})};
+
+		if (!Input || Input->TypeName != ExpectedInput.Value)
+		{
+			Errors.Add(FText::Format(NSLOCTEXT("Ambiverse", "FarFieldInputMissing", "Far field source '{0}' has no {1} input of type {2}."),
+				FText::FromString(Source->GetName()), FText::FromName(ExpectedInput.Key), FText::FromName(ExpectedInput.Value)));
+		}
+	}
+	
+	return Errors;
+}
+#endif
+
+void UAmbiverseFarFieldManager::Deinitialize(UAmbiverseSubsystem* Subsystem)
+{
+	for (int32 Index {Voices.Num() - 1}; Index >= 0; --Index)
+	{
+		ReleaseVoice(Index, 0.0f);
+	}
+	VoiceCursors.Empty();
+
+	if (UAmbiverseLayerManager* LayerManager {Subsystem ? Subsystem->GetLayerManager() : nullptr})
+	{
+		LayerManager->OnLayerUnregistered.RemoveDynamic(this, &UAmbiverseFarFieldManager::HandleOnLayerUnregistered);
+	}
+	
+	Super::Deinitialize(Subsystem);
+}
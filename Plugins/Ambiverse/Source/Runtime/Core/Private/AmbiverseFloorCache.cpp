@@ -0,0 +1,138 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseFloorCache.h"
+#include "AmbiverseStats.h"
+
+void FAmbiverseFloorCache::Initialize(UObject* Owner, const int32 InResolution, const float InCellSize, const float InTraceHalfHeight)
+{
+	Resolution = FMath::Max(2, InResolution);
+	CellSize = FMath::Max(1.0f, InCellSize);
+	TraceHalfHeight = FMath::Max(1.0f, InTraceHalfHeight);
+
+	Cells.Init(FCell(), Resolution * Resolution);
+
+	FillOrder.Reset(Cells.Num());
+	for (int32 Y {-Resolution / 2}; Y < Resolution - Resolution / 2; ++Y)
+	{
+		for (int32 X {-Resolution / 2}; X < Resolution - Resolution / 2; ++X)
+		{
+			FillOrder.Add(FIntPoint(X, Y));
+		}
+	}
+	FillOrder.Sort([](const FIntPoint& A, const FIntPoint& B) { return A.SizeSquared() < B.SizeSquared(); });
+
+	TraceDelegate = FTraceDelegate::CreateWeakLambda(Owner, [this](const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+	{
+		HandleTraceCompleted(TraceHandle, TraceDatum);
+	});
+}
+
+int32 FAmbiverseFloorCache::Update(UWorld* World, const FVector& ListenerLocation, const AActor* IgnoredActor, const int32 MaxTraceCount)
+{
+	if (!World || !IsInitialized()) { return 0; }
+
+	SCOPE_CYCLE_COUNTER(STAT_AmbiverseTracing);
+
+	/** Cells are only traced within a bounded range around the listener's height.
+	 *	If the listener has travelled too far vertically since the cells were traced, they are traced again. */
+	if (FMath::Abs(ListenerLocation.Z - ReferenceHeight) > TraceHalfHeight * 0.5f)
+	{
+		Invalidate();
+		ReferenceHeight = ListenerLocation.Z;
+	}
+
+	const FIntPoint Center {FMath::FloorToInt(ListenerLocation.X / CellSize), FMath::FloorToInt(ListenerLocation.Y / CellSize)};
+	Origin = Center - FIntPoint(Resolution / 2);
+
+	FCollisionQueryParams TraceParams(FName(TEXT("FloorCacheTrace")), false, IgnoredActor);
+	int32 TraceCount {0};
+
+	for (const FIntPoint& Offset : FillOrder)
+	{
+		if (TraceCount >= MaxTraceCount) { break; }
+
+		const FIntPoint GridCoordinates {Center + Offset};
+		const int32 CellIndex {GetCellIndex(GridCoordinates)};
+		FCell& Cell {Cells[CellIndex]};
+
+		/** A cell that belongs to different grid coordinates has scrolled out of the cache and is reused for this location. */
+		if (Cell.GridCoordinates == GridCoordinates && (Cell.IsValid || Cell.IsPending)) { continue; }
+
+		Cell.GridCoordinates = GridCoordinates;
+		Cell.IsValid = false;
+		Cell.IsPending = true;
+
+		const FVector Start {GridCoordinates.X * CellSize, GridCoordinates.Y * CellSize, ReferenceHeight + TraceHalfHeight};
+		const FVector End {Start.X, Start.Y, ReferenceHeight - TraceHalfHeight};
+
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECC_Visibility, TraceParams,
+			FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, static_cast<uint32>(CellIndex));
+
+		++TraceCount;
+	}
+
+	return TraceCount;
+}
+
+bool FAmbiverseFloorCache::SampleHeight(const FVector2D& Location, float& OutHeight) const
+{
+	if (!IsInitialized()) { return false; }
+
+	const double GridX {Location.X / CellSize};
+	const double GridY {Location.Y / CellSize};
+	const FIntPoint Min {FMath::FloorToInt(GridX), FMath::FloorToInt(GridY)};
+
+	const FCell* Cell00 {FindCell(Min)};
+	const FCell* Cell10 {FindCell(Min + FIntPoint(1, 0))};
+	const FCell* Cell01 {FindCell(Min + FIntPoint(0, 1))};
+	const FCell* Cell11 {FindCell(Min + FIntPoint(1, 1))};
+
+	if (!Cell00 || !Cell10 || !Cell01 || !Cell11) { return false; }
+
+	const float AlphaX {static_cast<float>(GridX - Min.X)};
+	const float AlphaY {static_cast<float>(GridY - Min.Y)};
+
+	OutHeight = FMath::BiLerp(Cell00->Height, Cell10->Height, Cell01->Height, Cell11->Height, AlphaX, AlphaY);
+	return true;
+}
+
+void FAmbiverseFloorCache::Invalidate()
+{
+	for (FCell& Cell : Cells)
+	{
+		Cell.IsValid = false;
+		Cell.IsPending = false;
+	}
+}
+
+void FAmbiverseFloorCache::HandleTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	if (!Cells.IsValidIndex(TraceDatum.UserData)) { return; }
+
+	FCell& Cell {Cells[TraceDatum.UserData]};
+
+	/** Discard results for cells that have been reused or invalidated since the trace was issued. */
+	const FIntPoint GridCoordinates {FMath::RoundToInt(TraceDatum.Start.X / CellSize), FMath::RoundToInt(TraceDatum.Start.Y / CellSize)};
+	if (!Cell.IsPending || Cell.GridCoordinates != GridCoordinates) { return; }
+	if (!FMath::IsNearlyEqual(TraceDatum.Start.Z, ReferenceHeight + TraceHalfHeight, 1.0)) { return; }
+
+	Cell.IsPending = false;
+	Cell.IsValid = true;
+	Cell.HasFloor = TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit;
+
+	if (Cell.HasFloor)
+	{
+		Cell.Height = TraceDatum.OutHits[0].ImpactPoint.Z;
+	}
+}
+
+const FAmbiverseFloorCache::FCell* FAmbiverseFloorCache::FindCell(const FIntPoint& GridCoordinates) const
+{
+	if (GridCoordinates.X < Origin.X || GridCoordinates.X >= Origin.X + Resolution) { return nullptr; }
+	if (GridCoordinates.Y < Origin.Y || GridCoordinates.Y >= Origin.Y + Resolution) { return nullptr; }
+
+	const FCell& Cell {Cells[GetCellIndex(GridCoordinates)]};
+	if (Cell.GridCoordinates != GridCoordinates || !Cell.IsValid || !Cell.HasFloor) { return nullptr; }
+
+	return &Cell;
+}
@@ -5,34 +5,75 @@
 #include "AmbiverseLayer.h"
 #include "AmbiverseParameterManager.h"
 #include "AmbiverseProceduralElement.h"
+#include "AmbiverseSoundSourceManager.h"
+#include "AmbiverseStats.h"
 #include "AmbiverseSubsystem.h"
+#include "AmbiverseTrace.h"
 
 DEFINE_LOG_CATEGORY_CLASS(UAmbiverseLayerManager, LogAmbiverseLayerManager);
 
-void UAmbiverseLayerManager::Initialize(UAmbiverseSubsystem* Subsystem)
+static TAutoConsoleVariable<int32> CVarMaxCatchUpFires(
+	TEXT("av.Scheduler.MaxCatchUpFires"), 4,
+	TEXT("The maximum number of times a single element can fire in one tick, for example after a hitch. Further missed events fire in the next ticks."));
+
+/** Simulation mode does not play sounds, so all missed events are fired. This only guards against elements with a zero interval. */
+static constexpr int32 MaxSimulationFiresPerTick {65536};
+
+void UAmbiverseLayerManager::Tick(const float DeltaTime)
 {
-	Super::Initialize(Subsystem);
+	if (!Owner) { return; }
 
-	if (UAmbiverseParameterManager* ParameterManager {Subsystem->GetParameterManager()})
+	SCOPE_CYCLE_COUNTER(STAT_AmbiverseLayerTick);
+	AMBIVERSE_TRACE_SCOPE(AmbiverseLayerTick);
+	
+	ElapsedTime += DeltaTime;
+	
+	if (const UAmbiverseParameterManager* ParameterManager {Owner->GetParameterManager()})
 	{
-		ParameterManager->OnParameterChangedDelegate.AddDynamic(this, &UAmbiverseLayerManager::HandleOnParameterChanged);
+		ApplyParameterChanges(ParameterManager->GetChangedParameters());
 	}
+	
+	UpdateFadingLayers(DeltaTime);
+	UpdateActiveLayers(DeltaTime, Owner->GetListenerStates());
+	ExpireLayers();
 }
 
-void UAmbiverseLayerManager::Tick(const float DeltaTime)
+int32 UAmbiverseLayerManager::GetScheduledEventCount() const
 {
-	UpdateActiveLayers(DeltaTime);
+	int32 Count {0};
+	for (const UAmbiverseLayer* Layer : ActiveLayers)
+	{
+		if (Layer)
+		{
+			Count += Layer->ProceduralElements.Num();
+		}
+	}
+	return Count;
 }
 
-void UAmbiverseLayerManager::UpdateActiveLayers(const float DeltaTime)
+void UAmbiverseLayerManager::UpdateActiveLayers(const float DeltaTime, const TArray<FAmbiverseListenerState>& Listeners)
 {
 	if (ActiveLayers.IsEmpty()) { return; }
 
 	for (UAmbiverseLayer* Layer : ActiveLayers)
 	{
 		if (!Layer) { continue; }
+
+		/** Layers that are scheduled by distance advance their elements by the distance travelled, expressed in seconds at the reference speed. */
+		float ElementDeltaTime {DeltaTime};
+		if (Layer->DistanceDensityWeight > 0.0f)
+		{
+			const int32 OwningListenerIndex {GetOwningListenerIndex(Layer)};
+			const int32 ListenerIndex {Listeners.IsValidIndex(OwningListenerIndex) ? OwningListenerIndex : 0};
+			const float ListenerSpeed {static_cast<float>(Listeners[ListenerIndex].Velocity.Size())};
+			const float SpeedRatio {ListenerSpeed / FMath::Max(Layer->ReferenceSpeed, 1.0f)};
+			ElementDeltaTime *= FMath::Lerp(1.0f, SpeedRatio, Layer->DistanceDensityWeight);
+		}
+
+		/** Crossfading layers advance their elements more slowly, so their density fades along with their volume. */
+		ElementDeltaTime *= Layer->TransitionFade;
 		
-		UpdateElements(DeltaTime, Layer);
+		UpdateElements(ElementDeltaTime, Layer, Listeners);
 
 		Layer->ActiveDuration += DeltaTime;
 		if (Layer->EnableLifetime)
@@ -49,26 +90,79 @@ void UAmbiverseLayerManager::UpdateActiveLayers(const float DeltaTime)
 	}
 }
 
-void UAmbiverseLayerManager::UpdateElements(const float DeltaTime, UAmbiverseLayer* Layer)
+void UAmbiverseLayerManager::UpdateElements(const float DeltaTime, UAmbiverseLayer* Layer, const TArray<FAmbiverseListenerState>& Listeners)
 {
 	if (!Layer || !Owner) { return; }
 	if (Layer->ProceduralElements.IsEmpty()) { return; }
+
+	AMBIVERSE_TRACE_SCOPE(AmbiverseUpdateElements);
+	
+	const int32 MaxFireCount {Owner->IsSimulationMode() ? MaxSimulationFiresPerTick : CVarMaxCatchUpFires.GetValueOnGameThread()};
 	
-	for (FAmbiverseProceduralElement& ProceduralElement : Layer->ProceduralElements)
+	for (int32 ElementIndex {0}; ElementIndex < Layer->ProceduralElements.Num(); ++ElementIndex)
 	{
-		const float ScaleFactor {(ProceduralElement.Time - DeltaTime) / ProceduralElement.Time};
-		ProceduralElement.ReferenceTime *= ScaleFactor;
+		FAmbiverseProceduralElement& ProceduralElement {Layer->ProceduralElements[ElementIndex]};
+		
+		/** Beds are played continuously by the bed manager, and are never fired. */
+		if (ProceduralElement.Element && ProceduralElement.Element->IsBed()) { continue; }
+		
+		/** The reference time shrinks along with the remaining time, so the ratio between them stays equal to the density modifier. */
+		if (ProceduralElement.Time > UE_KINDA_SMALL_NUMBER)
+		{
+			ProceduralElement.ReferenceTime *= FMath::Max(0.0f, (ProceduralElement.Time - DeltaTime) / ProceduralElement.Time);
+		}
+		else
+		{
+			ProceduralElement.ReferenceTime = 0.0f;
+		}
 		
 		ProceduralElement.Time -= DeltaTime;
 
-		if (ProceduralElement.Time <= 0)
+		/** If more than one interval elapsed during this tick, every missed event is fired in order.
+		 *	The overshoot is carried over to the next interval, so the schedule does not drift with the tick rate.
+		 *	Events beyond the fire limit keep their negative time, so they fire in the next ticks with their lateness intact. */
+		int32 FireCount {0};
+		while (ProceduralElement.Time <= 0.0f)
 		{
-			Owner->ProcessProceduralElement(Layer, ProceduralElement);
+			if (FireCount >= MaxFireCount)
+			{
+				UE_LOG(LogAmbiverseLayerManager, Verbose, TEXT("UpdateElements: Deferred missed events of '%s' after %d fires."),
+					*GetNameSafe(ProceduralElement.Element), FireCount);
+				++Owner->GetFrameCounters().DeferredEvents;
+				break;
+			}
+			
+			const float Overshoot {-ProceduralElement.Time};
+			Owner->ProcessProceduralElement(Layer, ElementIndex, Listeners);
+			ProceduralElement.Time -= Overshoot;
+			
+			++FireCount;
 		}
 	}
 }
 
-void UAmbiverseLayerManager::RegisterAmbiverseLayer(UAmbiverseLayer* Layer)
+void UAmbiverseLayerManager::ExpireLayers()
+{
+	while (!ExpiryQueue.IsEmpty() && ExpiryQueue.HeapTop().ExpiryTime <= ElapsedTime)
+	{
+		FLayerExpiry Expiry;
+		ExpiryQueue.HeapPop(Expiry, false);
+
+		UAmbiverseLayer* Layer {Expiry.Layer.Get()};
+		if (!Layer) { continue; }
+
+		UE_LOG(LogAmbiverseLayerManager, Verbose, TEXT("ExpireLayers: Layer '%s' expired after %.2f seconds."), *Layer->GetName(), Layer->ActiveDuration);
+
+		if (UAmbiverseSoundSourceManager* SoundSourceManager {Owner ? Owner->GetSoundSourceManager() : nullptr})
+		{
+			SoundSourceManager->ReleaseLayerSoundSources(Layer, Layer->ExpiryFadeOutDuration);
+		}
+		
+		UnregisterAmbiverseLayer(Layer);
+	}
+}
+
+void UAmbiverseLayerManager::RegisterAmbiverseLayer(UAmbiverseLayer* Layer, const int32 OwningListenerIndex)
 {
 	if (!Layer)
 	{
@@ -85,8 +179,20 @@ void UAmbiverseLayerManager::RegisterAmbiverseLayer(UAmbiverseLayer* Layer)
 	
 	if (!FindActiveAmbienceLayer(Layer))
 	{
+		if (OwningListenerIndex != INDEX_NONE)
+		{
+			OwningListenerIndices.Add(Layer, OwningListenerIndex);
+		}
+		
 		InitializeLayer(Layer);
 		ActiveLayers.Add(Layer);
+		ActiveLayerSet.Add(Layer);
+
+		/** The lifetime is read once, so changes to the lifetime of an active layer take effect when it is registered again. */
+		if (Layer->EnableLifetime)
+		{
+			ExpiryQueue.HeapPush({ElapsedTime + Layer->Lifetime, Layer});
+		}
 		
 		OnLayerRegistered.Broadcast(Layer);
 
@@ -94,53 +200,34 @@ void UAmbiverseLayerManager::RegisterAmbiverseLayer(UAmbiverseLayer* Layer)
 	}
 }
 
-void UAmbiverseLayerManager::InitializeLayer(UAmbiverseLayer* Layer, const uint16 WarmUpCount)
+void UAmbiverseLayerManager::InitializeLayer(UAmbiverseLayer* Layer, const bool WarmUp)
 {
 	if (!Layer) { return; }
+
+	Layer->ActiveDuration = 0.0f;
+	Layer->LifetimeRatio = 0.0f;
 	
-	Layer->ProceduralElements.RemoveAll([](const FAmbiverseProceduralElement& Element){ return !Element.IsValid(); });
+	/** Cooked layers are compiled when they are saved. Layers in the editor can change between registrations, so they are compiled again. */
+#if WITH_EDITOR
+	Layer->Compile();
+#else
+	if (!Layer->GetCompiledLayer().GetIsCompiled())
+	{
+		Layer->Compile();
+	}
+#endif
 
-	if (WarmUpCount > 0 && Layer->ProceduralElements.Num() > 0)
+	if (!Owner) { return; }
+	
+	for (int32 ElementIndex {0}; ElementIndex < Layer->ProceduralElements.Num(); ++ElementIndex)
 	{
-		for(int i {0}; i < WarmUpCount; ++i) 
+		if (WarmUp)
 		{
-			FAmbiverseProceduralElement* MinElement {&Layer->ProceduralElements[0]};
-
-			for (FAmbiverseProceduralElement& Element : Layer->ProceduralElements)
-			{
-				if (Owner)
-				{
-					Owner->SetNewTimeForProceduralElement(Element, Layer);
-				}
-
-				if (Element.Time < MinElement->Time)
-				{
-					MinElement = &Element;
-				}
-			}
-
-			for (FAmbiverseProceduralElement& Element : Layer->ProceduralElements)
-			{
-				if (&Element != MinElement)
-				{
-					Element.Time -= MinElement->Time;
-				}
-			}
-
-			if (Owner)
-			{
-				Owner->SetNewTimeForProceduralElement(*MinElement, Layer);
-			}
+			Owner->WarmUpProceduralElement(Layer, ElementIndex);
 		}
-	}
-	else
-	{
-		for (FAmbiverseProceduralElement& Element : Layer->ProceduralElements)
+		else
 		{
-			if (Owner)
-			{
-				Owner->SetNewTimeForProceduralElement(Element, Layer);
-			}
+			Owner->SetNewTimeForProceduralElement(Layer, ElementIndex);
 		}
 	}
 
@@ -154,9 +241,22 @@ void UAmbiverseLayerManager::UnregisterAmbiverseLayer(UAmbiverseLayer* Layer)
 		UE_LOG(LogAmbiverseLayerManager, Warning, TEXT("UnregisterAmbiverseLayer: No Layer provided."));
 		return;
 	}
-	if (ActiveLayers.Contains(Layer))
+	if (ActiveLayerSet.Remove(Layer) > 0)
 	{
 		ActiveLayers.Remove(Layer);
+		FadingLayers.Remove(Layer);
+		OwningListenerIndices.Remove(Layer);
+		Layer->TransitionFade = 1.0f;
+
+		/** Unregistering is rare compared to ticking, so the expiry queue is rebuilt here instead of checking for stale entries every tick. */
+		if (ExpiryQueue.RemoveAll([Layer](const FLayerExpiry& Expiry) { return Expiry.Layer == Layer; }) > 0)
+		{
+			ExpiryQueue.Heapify();
+		}
+
+		Layer->ActiveDuration = 0.0f;
+		Layer->LifetimeRatio = 0.0f;
+		
 		OnLayerUnregistered.Broadcast(Layer);
 
 		UE_LOG(LogAmbiverseLayerManager, Verbose, TEXT("Unregistered Ambiverse Layer:: '%s'."), *Layer->GetName());
@@ -171,65 +271,244 @@ void UAmbiverseLayerManager::RegisterAmbiverseComposite(UAmbiverseComposite* Com
 		return;
 	}
 
-	if (Composite->StopNonCompositeLayers)
+	TArray<UAmbiverseLayer*> TargetLayers;
+	if (!Composite->StopNonCompositeLayers)
+	{
+		TargetLayers = GetRemainingLayers();
+	}
+	TargetLayers.Append(Composite->Layers);
+	
+	TransitionToLayers(TargetLayers, Composite->CrossfadeDuration);
+}
+
+void UAmbiverseLayerManager::UnregisterAmbiverseComposite(UAmbiverseComposite* Composite)
+{
+	if (!Composite)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UnregisterAmbiverseComposite: No Composite provided."));
+		return;
+	}
+
+	const TSet<UAmbiverseLayer*> CompositeLayers {Composite->Layers};
+	
+	TArray<UAmbiverseLayer*> TargetLayers {GetRemainingLayers()};
+	TargetLayers.RemoveAll([&CompositeLayers](UAmbiverseLayer* Layer) { return CompositeLayers.Contains(Layer); });
+	
+	TransitionToLayers(TargetLayers, Composite->CrossfadeDuration);
+}
+
+void UAmbiverseLayerManager::PushComposite(UAmbiverseComposite* Composite)
+{
+	if (!Composite)
+	{
+		UE_LOG(LogAmbiverseLayerManager, Warning, TEXT("PushComposite: No Composite provided."));
+		return;
+	}
+
+	CompositeStack.Add(Composite);
+	RegisterAmbiverseComposite(Composite);
+	
+	UE_LOG(LogAmbiverseLayerManager, Verbose, TEXT("PushComposite: Pushed '%s', stack depth %d."), *Composite->GetName(), CompositeStack.Num());
+}
+
+void UAmbiverseLayerManager::PopComposite()
+{
+	if (CompositeStack.IsEmpty())
+	{
+		UE_LOG(LogAmbiverseLayerManager, Warning, TEXT("PopComposite: The composite stack is empty."));
+		return;
+	}
+
+	/** Layers of the stack are replaced by the layers of the remaining stack. Layers that were registered on their own are kept. */
+	const TSet<UAmbiverseLayer*> PreviousStackLayers {GetCompositeStackLayers()};
+	UAmbiverseComposite* Composite {CompositeStack.Pop(false)};
+
+	TArray<UAmbiverseLayer*> TargetLayers {GetRemainingLayers()};
+	TargetLayers.RemoveAll([&PreviousStackLayers](UAmbiverseLayer* Layer) { return PreviousStackLayers.Contains(Layer); });
+	TargetLayers.Append(GetCompositeStackLayers());
+	
+	TransitionToLayers(TargetLayers, Composite ? Composite->CrossfadeDuration : 0.0f);
+
+	UE_LOG(LogAmbiverseLayerManager, Verbose, TEXT("PopComposite: Popped '%s', stack depth %d."), *GetNameSafe(Composite), CompositeStack.Num());
+}
+
+void UAmbiverseLayerManager::TransitionToLayers(const TArray<UAmbiverseLayer*>& TargetLayers, const float CrossfadeDuration)
+{
+	const TSet<UAmbiverseLayer*> TargetLayerSet {TargetLayers};
+	const float FadeRate {CrossfadeDuration > 0.0f ? 1.0f / CrossfadeDuration : 0.0f};
+
+	/** The difference is computed in full before any layer is registered or unregistered, as both modify the active layers. */
+	TArray<UAmbiverseLayer*> LayersToRemove;
+	for (UAmbiverseLayer* Layer : ActiveLayers)
 	{
-		for (UAmbiverseLayer* Layer : ActiveLayers)
+		if (!TargetLayerSet.Contains(Layer))
 		{
-			if (!Composite->Layers.Contains(Layer))
+			LayersToRemove.Add(Layer);
+		}
+	}
+
+	TArray<UAmbiverseLayer*> LayersToAdd;
+	for (UAmbiverseLayer* Layer : TargetLayers)
+	{
+		if (!Layer) { continue; }
+
+		/** A layer that is still fading out from an earlier transition fades back in. */
+		if (ActiveLayerSet.Contains(Layer))
+		{
+			float* Rate {FadingLayers.Find(Layer)};
+			if (!Rate || *Rate > 0.0f) { continue; }
+			
+			if (FadeRate > 0.0f)
 			{
-				UnregisterAmbiverseLayer(Layer);
+				*Rate = FadeRate;
 			}
+			else
+			{
+				FadingLayers.Remove(Layer);
+				Layer->TransitionFade = 1.0f;
+			}
+		}
+		else if (!LayersToAdd.Contains(Layer))
+		{
+			LayersToAdd.Add(Layer);
+		}
+	}
+
+	UAmbiverseSoundSourceManager* SoundSourceManager {Owner ? Owner->GetSoundSourceManager() : nullptr};
+	
+	for (UAmbiverseLayer* Layer : LayersToRemove)
+	{
+		if (FadeRate > 0.0f)
+		{
+			const float* Rate {FadingLayers.Find(Layer)};
+			const bool IsFadingOut {Rate && *Rate < 0.0f};
+			FadingLayers.Add(Layer, -FadeRate);
+
+			/** The transition fade only scales sounds that start during the transition, so sounds that are already playing fade out along with it. */
+			if (SoundSourceManager && !IsFadingOut)
+			{
+				SoundSourceManager->ReleaseLayerSoundSources(Layer, Layer->TransitionFade / FadeRate);
+			}
+		}
+		else
+		{
+			UnregisterAmbiverseLayer(Layer);
 		}
 	}
 
-	for (UAmbiverseLayer* Layer : Composite->Layers)
+	for (UAmbiverseLayer* Layer : LayersToAdd)
 	{
 		RegisterAmbiverseLayer(Layer);
+		
+		/** New layers start silent, which also spreads out the first events of their warmed up elements. */
+		if (FadeRate > 0.0f && ActiveLayerSet.Contains(Layer))
+		{
+			Layer->TransitionFade = 0.0f;
+			FadingLayers.Add(Layer, FadeRate);
+		}
 	}
+
+	UE_LOG(LogAmbiverseLayerManager, Verbose, TEXT("TransitionToLayers: Adding %d layers and removing %d layers over %.2f seconds."),
+		LayersToAdd.Num(), LayersToRemove.Num(), CrossfadeDuration);
 }
 
-void UAmbiverseLayerManager::UnregisterAmbiverseComposite(UAmbiverseComposite* Composite)
+void UAmbiverseLayerManager::UpdateFadingLayers(const float DeltaTime)
 {
-	if (!Composite)
+	if (FadingLayers.IsEmpty()) { return; }
+
+	TArray<UAmbiverseLayer*> SilentLayers;
+	
+	for (auto Iterator {FadingLayers.CreateIterator()}; Iterator; ++Iterator)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("UnregisterAmbiverseComposite: No Composite provided."));
-		return;
+		UAmbiverseLayer* Layer {Iterator.Key()};
+		Layer->TransitionFade = FMath::Clamp(Layer->TransitionFade + Iterator.Value() * DeltaTime, 0.0f, 1.0f);
+
+		if (Iterator.Value() > 0.0f && Layer->TransitionFade >= 1.0f)
+		{
+			Iterator.RemoveCurrent();
+		}
+		else if (Iterator.Value() < 0.0f && Layer->TransitionFade <= 0.0f)
+		{
+			SilentLayers.Add(Layer);
+		}
 	}
 
-	for (UAmbiverseLayer* Layer : Composite->Layers)
+	for (UAmbiverseLayer* Layer : SilentLayers)
 	{
 		UnregisterAmbiverseLayer(Layer);
 	}
 }
 
-UAmbiverseLayer* UAmbiverseLayerManager::FindActiveAmbienceLayer(const UAmbiverseLayer* LayerToFind) const
+TArray<UAmbiverseLayer*> UAmbiverseLayerManager::GetRemainingLayers() const
 {
+	TArray<UAmbiverseLayer*> Layers;
+	Layers.Reserve(ActiveLayers.Num());
+	
 	for (UAmbiverseLayer* Layer : ActiveLayers)
 	{
-		if (Layer == LayerToFind)
+		const float* Rate {FadingLayers.Find(Layer)};
+		if (!Rate || *Rate > 0.0f)
 		{
-			return Layer;
+			Layers.Add(Layer);
 		}
 	}
-
-	return nullptr;
+	
+	return Layers;
 }
 
-void UAmbiverseLayerManager::HandleOnParameterChanged(UAmbiverseParameter* ChangedParameter)
+TArray<UAmbiverseLayer*> UAmbiverseLayerManager::GetCompositeStackLayers() const
 {
+	int32 FirstIndex {0};
+	for (int32 Index {CompositeStack.Num() - 1}; Index >= 0; --Index)
+	{
+		if (CompositeStack[Index] && CompositeStack[Index]->StopNonCompositeLayers)
+		{
+			FirstIndex = Index;
+			break;
+		}
+	}
+
+	TArray<UAmbiverseLayer*> Layers;
+	for (int32 Index {FirstIndex}; Index < CompositeStack.Num(); ++Index)
+	{
+		if (CompositeStack[Index])
+		{
+			Layers.Append(CompositeStack[Index]->Layers);
+		}
+	}
 	
+	return Layers;
 }
 
-void UAmbiverseLayerManager::Deinitialize(UAmbiverseSubsystem* Subsystem)
+UAmbiverseLayer* UAmbiverseLayerManager::FindActiveAmbienceLayer(const UAmbiverseLayer* LayerToFind) const
 {
-	if (!Subsystem) { return; }
-	
-	if (UAmbiverseParameterManager* ParameterManager {Subsystem->GetParameterManager()})
+	UAmbiverseLayer* Layer {const_cast<UAmbiverseLayer*>(LayerToFind)};
+	return ActiveLayerSet.Contains(Layer) ? Layer : nullptr;
+}
+
+void UAmbiverseLayerManager::ApplyParameterChanges(const TArray<UAmbiverseParameter*>& ChangedParameters)
+{
+	if (ChangedParameters.IsEmpty()) { return; }
+
+	for (UAmbiverseLayer* Layer : ActiveLayers)
 	{
-		ParameterManager->OnParameterChangedDelegate.RemoveDynamic(this, &UAmbiverseLayerManager::HandleOnParameterChanged);
+		if (!Layer) { continue; }
+
+		const FAmbiverseCompiledLayer& CompiledLayer {Layer->GetCompiledLayer()};
+		const uint64 ChangedMask {CompiledLayer.GetParameterMask(ChangedParameters)};
+		
+		if (ChangedMask == 0) { continue; }
+
+		/** The reference time is the remaining interval without any modifiers, so the time can be rescaled to the new density without losing progress.
+		 *	Only the elements that depend on a changed parameter are rescaled. */
+		for (int32 ElementIndex {0}; ElementIndex < Layer->ProceduralElements.Num(); ++ElementIndex)
+		{
+			if (!(CompiledLayer.GetElementParameterMask(ElementIndex) & ChangedMask)) { continue; }
+
+			FAmbiverseProceduralElement& ProceduralElement {Layer->ProceduralElements[ElementIndex]};
+			ProceduralElement.Time = ProceduralElement.ReferenceTime * Owner->GetDensityModifier(Layer, ElementIndex);
+		}
 	}
-	
-	Super::Deinitialize(Subsystem);
 }
 
 
@@ -0,0 +1,207 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseParameterBindingComponent.h"
+#include "AmbiverseParameterManager.h"
+#include "AmbiverseSubsystem.h"
+#include "GameFramework/MovementComponent.h"
+
+DEFINE_LOG_CATEGORY_CLASS(UAmbiverseParameterBindingComponent, LogAmbiverseParameterBinding);
+
+UAmbiverseParameterBindingComponent::UAmbiverseParameterBindingComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UAmbiverseParameterBindingComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UAmbiverseParameterManager* ParameterManager {GetParameterManager()};
+	if (!ParameterManager) { return; }
+
+	for (FAmbiverseParameterBinding& Binding : Bindings)
+	{
+		Binding.Handle = ParameterManager->GetParameterHandle(Binding.Parameter);
+		Binding.TimeUntilSample = 0.0f;
+		Binding.HasValue = false;
+		Binding.IsResolved = false;
+	}
+
+	ParameterManager->RegisterBindingComponent(this);
+}
+
+void UAmbiverseParameterBindingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UAmbiverseParameterManager* ParameterManager {GetParameterManager()})
+	{
+		ParameterManager->UnregisterBindingComponent(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UAmbiverseParameterBindingComponent::UpdateBindings(const float DeltaTime, UAmbiverseParameterManager* ParameterManager)
+{
+	if (!ParameterManager) { return; }
+
+	for (FAmbiverseParameterBinding& Binding : Bindings)
+	{
+		if (!Binding.Handle.IsValid()) { continue; }
+
+		Binding.TimeUntilSample -= DeltaTime;
+		if (Binding.TimeUntilSample > 0.0f) { continue; }
+
+		Binding.TimeUntilSample = Binding.SampleRate > 0.0f ? FMath::Max(Binding.TimeUntilSample + 1.0f / Binding.SampleRate, 0.0f) : 0.0f;
+
+		float Value {0.0f};
+		if (!SampleBinding(Binding, Value)) { continue; }
+
+		Value *= Binding.Scale;
+		if (Binding.HasValue && FMath::Abs(Value - Binding.LastValue) < Binding.ChangeThreshold) { continue; }
+
+		Binding.LastValue = Value;
+		Binding.HasValue = true;
+		
+		ParameterManager->SetParameters(MakeArrayView(&Binding.Handle, 1), MakeArrayView(&Value, 1));
+	}
+}
+
+void UAmbiverseParameterBindingComponent::ResolveBinding(FAmbiverseParameterBinding& Binding) const
+{
+	Binding.IsResolved = true;
+	Binding.Target = nullptr;
+	Binding.Function = nullptr;
+	Binding.Property.Reset();
+
+	AActor* Actor {GetOwner()};
+	if (!Actor) { return; }
+
+	UObject* Target {Actor};
+	if (Binding.ComponentClass)
+	{
+		Target = Actor->FindComponentByClass(Binding.ComponentClass);
+	}
+	else if (Binding.Source == EAmbiverseBindingSource::Speed)
+	{
+		if (UMovementComponent* MovementComponent {Actor->FindComponentByClass<UMovementComponent>()})
+		{
+			Target = MovementComponent;
+		}
+	}
+
+	if (!Target)
+	{
+		UE_LOG(LogAmbiverseParameterBinding, Warning, TEXT("ResolveBinding: No component of class '%s' found on '%s'."),
+			*GetNameSafe(Binding.ComponentClass), *Actor->GetName());
+		return;
+	}
+
+	Binding.Target = Target;
+
+	if (Binding.Source == EAmbiverseBindingSource::FloatProperty)
+	{
+		Binding.Property = FindFProperty<FNumericProperty>(Target->GetClass(), Binding.MemberName);
+		if (!Binding.Property.Get())
+		{
+			UE_LOG(LogAmbiverseParameterBinding, Warning, TEXT("ResolveBinding: '%s' has no numeric property named '%s'."),
+				*Target->GetName(), *Binding.MemberName.ToString());
+		}
+	}
+	else if (Binding.Source == EAmbiverseBindingSource::Function)
+	{
+		UFunction* Function {Target->FindFunction(Binding.MemberName)};
+		
+		/** Only functions whose sole parameter is a numeric return value can be sampled. */
+		if (!Function || Function->NumParms != 1 || !CastField<FNumericProperty>(Function->GetReturnProperty()))
+		{
+			UE_LOG(LogAmbiverseParameterBinding, Warning, TEXT("ResolveBinding: '%s' has no function named '%s' without parameters that returns a number."),
+				*Target->GetName(), *Binding.MemberName.ToString());
+			return;
+		}
+		Binding.Function = Function;
+	}
+}
+
+bool UAmbiverseParameterBindingComponent::SampleBinding(FAmbiverseParameterBinding& Binding, float& OutValue) const
+{
+	if (Binding.Source == EAmbiverseBindingSource::CurveTable)
+	{
+		const UWorld* World {GetWorld()};
+		if (!World) { return false; }
+		
+		return Binding.CurveRow.Eval(World->GetTimeSeconds(), &OutValue, TEXT("AmbiverseParameterBinding"));
+	}
+
+	if (!Binding.IsResolved || Binding.Target.IsStale())
+	{
+		ResolveBinding(Binding);
+	}
+
+	UObject* Target {Binding.Target.Get()};
+	if (!Target) { return false; }
+
+	switch (Binding.Source)
+	{
+	case EAmbiverseBindingSource::Speed:
+		{
+			if (const UMovementComponent* MovementComponent {Cast<UMovementComponent>(Target)})
+			{
+				OutValue = MovementComponent->Velocity.Size();
+				return true;
+			}
+			if (const AActor* Actor {Cast<AActor>(Target)})
+			{
+				OutValue = Actor->GetVelocity().Size();
+				return true;
+			}
+			if (const USceneComponent* SceneComponent {Cast<USceneComponent>(Target)})
+			{
+				OutValue = SceneComponent->GetComponentVelocity().Size();
+				return true;
+			}
+			return false;
+		}
+	case EAmbiverseBindingSource::FloatProperty:
+		{
+			/** The property is held by path, so it resolves to null instead of dangling if its class is reinstanced. */
+			const FNumericProperty* Property {Binding.Property.Get()};
+			if (!Property) { return false; }
+			
+			const void* ValuePtr {Property->ContainerPtrToValuePtr<void>(Target)};
+			OutValue = Property->IsFloatingPoint()
+				? static_cast<float>(Property->GetFloatingPointPropertyValue(ValuePtr))
+				: static_cast<float>(Property->GetSignedIntPropertyValue(ValuePtr));
+			return true;
+		}
+	case EAmbiverseBindingSource::Function:
+		{
+			UFunction* Function {Binding.Function.Get()};
+			if (!Function) { return false; }
+
+			uint8* Parameters {static_cast<uint8*>(FMemory_Alloca(Function->ParmsSize))};
+			FMemory::Memzero(Parameters, Function->ParmsSize);
+			Target->ProcessEvent(Function, Parameters);
+
+			const FNumericProperty* ReturnProperty {CastField<FNumericProperty>(Function->GetReturnProperty())};
+			const void* ValuePtr {ReturnProperty->ContainerPtrToValuePtr<void>(Parameters)};
+			OutValue = ReturnProperty->IsFloatingPoint()
+				? static_cast<float>(ReturnProperty->GetFloatingPointPropertyValue(ValuePtr))
+				: static_cast<float>(ReturnProperty->GetSignedIntPropertyValue(ValuePtr));
+			return true;
+		}
+	default:
+		return false;
+	}
+}
+
+UAmbiverseParameterManager* UAmbiverseParameterBindingComponent::GetParameterManager() const
+{
+	if (const UWorld* World {GetWorld()})
+	{
+		if (const UAmbiverseSubsystem* AmbiverseSubsystem {World->GetSubsystem<UAmbiverseSubsystem>()})
+		{
+			return AmbiverseSubsystem->GetParameterManager();
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseParameterMailbox.h"
+
+DEFINE_LOG_CATEGORY_CLASS(FAmbiverseParameterMailbox, LogAmbiverseParameterMailbox);
+
+void FAmbiverseParameterMailbox::SetParameters(TArrayView<const FAmbiverseParameterHandle> Handles, TArrayView<const float> Values)
+{
+	if (Handles.Num() != Values.Num())
+	{
+		UE_LOG(LogAmbiverseParameterMailbox, Warning, TEXT("SetParameters: %d handles were provided with %d values."), Handles.Num(), Values.Num());
+		return;
+	}
+
+	for (int32 Index {0}; Index < Handles.Num(); ++Index)
+	{
+		const int32 ParameterIndex {Handles[Index].Index};
+		if (ParameterIndex < 0) { continue; }
+
+		if (ParameterIndex >= ProducerSnapshot.Values.Num())
+		{
+			ProducerSnapshot.Values.SetNumZeroed(ParameterIndex + 1);
+			ProducerSnapshot.IsSet.Add(false, ParameterIndex + 1 - ProducerSnapshot.IsSet.Num());
+		}
+
+		ProducerSnapshot.Values[ParameterIndex] = Values[Index];
+		ProducerSnapshot.IsSet[ParameterIndex] = true;
+	}
+
+	/** The write buffer is owned by the producer until it is swapped, so it can be filled without synchronization. */
+	FSnapshot& WriteBuffer {Buffer.GetWriteBuffer()};
+	WriteBuffer.Values = ProducerSnapshot.Values;
+	WriteBuffer.IsSet = ProducerSnapshot.IsSet;
+	Buffer.SwapWriteBuffers();
+}
+
+void FAmbiverseParameterMailbox::SetParameter(const FAmbiverseParameterHandle Handle, const float Value)
+{
+	SetParameters(MakeArrayView(&Handle, 1), MakeArrayView(&Value, 1));
+}
+
+bool FAmbiverseParameterMailbox::Consume(TFunctionRef<void(const int32 Index, const float Value)> Consumer)
+{
+	check(IsInGameThread());
+	
+	if (!Buffer.IsDirty()) { return false; }
+
+	Buffer.SwapReadBuffers();
+	const FSnapshot& Snapshot {Buffer.Read()};
+
+	if (ConsumerSnapshot.Values.Num() < Snapshot.Values.Num())
+	{
+		ConsumerSnapshot.Values.SetNumZeroed(Snapshot.Values.Num());
+		ConsumerSnapshot.IsSet.Add(false, Snapshot.Values.Num() - ConsumerSnapshot.IsSet.Num());
+	}
+
+	for (TConstSetBitIterator<> It(Snapshot.IsSet); It; ++It)
+	{
+		const int32 Index {It.GetIndex()};
+		const float Value {Snapshot.Values[Index]};
+		
+		if (ConsumerSnapshot.IsSet[Index] && ConsumerSnapshot.Values[Index] == Value) { continue; }
+
+		ConsumerSnapshot.Values[Index] = Value;
+		ConsumerSnapshot.IsSet[Index] = true;
+		Consumer(Index, Value);
+	}
+
+	return true;
+}
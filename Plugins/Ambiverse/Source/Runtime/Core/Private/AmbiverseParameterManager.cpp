@@ -3,7 +3,10 @@
 #include "AmbiverseParameterManager.h"
 #include "AmbiverseLayerManager.h"
 #include "AmbiverseParameter.h"
+#include "AmbiverseParameterBindingComponent.h"
+#include "AmbiverseStats.h"
 #include "AmbiverseSubsystem.h"
+#include "AmbiverseTrace.h"
 
 DEFINE_LOG_CATEGORY_CLASS(UAmbiverseParameterManager, LogAmbiverseParameterManager);
 
@@ -17,85 +20,190 @@ void UAmbiverseParameterManager::Initialize(UAmbiverseSubsystem* Subsystem)
 	}
 }
 
-void UAmbiverseParameterManager::GetScalarsForElement(float& DensityScalar, float& VolumeScalar, const UAmbiverseLayer* Layer, const FAmbiverseProceduralElement& ProceduralElement)
+void UAmbiverseParameterManager::GetScalarsForElement(float& DensityScalar, float& VolumeScalar, const UAmbiverseLayer* Layer, const int32 ElementIndex)
 {
 	DensityScalar = 1.0f;
 	VolumeScalar = 1.0f;
 	
-	if (!Layer) { return; }
-	
-	TArray<FAmbiverseParameterModifiers> Parameters;
+	if (!Layer || !Layer->ProceduralElements.IsValidIndex(ElementIndex)) { return; }
+
+	SCOPE_CYCLE_COUNTER(STAT_AmbiverseParameterEvaluation);
+	AMBIVERSE_TRACE_SCOPE(AmbiverseGetScalarsForElement);
 	
-	Parameters.Append(Layer->Parameters);
-	// Parameters.Append(ProceduralElement.Element.Parameters); // For now, we're not implementing parameters inside elements.
+	/** Compiled layers store the merged modifiers of each element in a flat table with direct references to their parameters.
+	 *	Their parameters are registered when the layer is registered, so the compiled path does not look them up. */
+	const FAmbiverseCompiledLayer& CompiledLayer {Layer->GetCompiledLayer()};
 	
-	if (Parameters.IsEmpty()) { return; }
-
-	for (const FAmbiverseParameterModifiers& Modifier : Parameters)
+	if (CompiledLayer.GetIsCompiled() && ElementIndex < CompiledLayer.GetElementCount())
 	{
-		UAmbiverseParameter* RegisteredParameter {nullptr};
+		CompiledLayer.GetParameterScalars(ElementIndex, DensityScalar, VolumeScalar);
 		
-		for (UAmbiverseParameter* Parameter : ParameterRegistry)
+		DensityScalar = 1.0f / FMath::Max(DensityScalar * Layer->LayerDensity, UE_KINDA_SMALL_NUMBER);
+		VolumeScalar *= Layer->LayerVolume;
+		return;
+	}
+
+	auto ApplyModifiers = [this, &DensityScalar, &VolumeScalar](const TArray<FAmbiverseParameterModifiers>& Modifiers)
+	{
+		for (const FAmbiverseParameterModifiers& Modifier : Modifiers)
 		{
-			if (Parameter == Modifier.Parameter)
+			UAmbiverseParameter* RegisteredParameter {Modifier.Parameter};
+
+			if (!IsParameterRegistered(RegisteredParameter))
 			{
-				RegisteredParameter = Parameter;
-				break;
+				RegisterParameter(Modifier.Parameter);
+				continue;
 			}
+
+			DensityScalar *= Modifier.GetDensity(RegisteredParameter->ParameterValue);
+			VolumeScalar *= Modifier.GetVolume(RegisteredParameter->ParameterValue);
 		}
+	};
+
+	ApplyModifiers(Layer->Parameters);
+	ApplyModifiers(Layer->ProceduralElements[ElementIndex].Parameters);
 
-		if (!RegisteredParameter)
+	/** A density of zero would stop the element forever, so it is clamped to a very long interval instead. */
+	DensityScalar = 1.0f / FMath::Max(DensityScalar * Layer->LayerDensity, UE_KINDA_SMALL_NUMBER);
+	VolumeScalar *= Layer->LayerVolume;
+}
+
+void UAmbiverseParameterManager::Tick(const float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AmbiverseParameterEvaluation);
+	
+	ChangedParameters.Reset();
+
+	for (int32 Index {BindingComponents.Num() - 1}; Index >= 0; --Index)
+	{
+		UAmbiverseParameterBindingComponent* BindingComponent {BindingComponents[Index].Get()};
+		if (!BindingComponent)
 		{
-			RegisterParameter(Modifier.Parameter);
+			BindingComponents.RemoveAtSwap(Index);
 			continue;
 		}
+		BindingComponent->UpdateBindings(DeltaTime, this);
+	}
 
-		DensityScalar *= FMath::GetMappedRangeValueClamped(FVector2D(0, 1), Modifier.DensityRange, RegisteredParameter->ParameterValue);
-		VolumeScalar *= FMath::GetMappedRangeValueClamped(FVector2D(0, 1), Modifier.VolumeRange, RegisteredParameter->ParameterValue);
+	/** Values from other threads are applied as if they were set on the game thread before this tick. */
+	ParameterMailbox->Consume([this](const int32 Index, const float Value)
+	{
+		SetParameterValueAtIndex(Index, Value);
+	});
+
+	for (int32 Index {0}; Index < ParameterRegistry.Num(); ++Index)
+	{
+		UAmbiverseParameter* Parameter {ParameterRegistry[Index]};
+		if (!Parameter) { continue; }
+
+		FParameterState& State {ParameterStates[Index]};
+		if (Parameter->ParameterValue != State.TargetValue)
+		{
+			Parameter->ParameterValue = Parameter->SmoothValue(Parameter->ParameterValue, State.TargetValue, State.Velocity, DeltaTime);
+			DirtyParameters[Index] = true;
+		}
+
+		if (DirtyParameters[Index])
+		{
+			ChangedParameters.Add(Parameter);
+		}
 	}
 
-	DensityScalar *= Layer->LayerDensity;
-	DensityScalar = 1 / DensityScalar;
-	VolumeScalar *= Layer->LayerVolume;
+	if (ChangedParameters.IsEmpty()) { return; }
+
+	DirtyParameters.SetRange(0, DirtyParameters.Num(), false);
+
+	for (UAmbiverseParameter* ChangedParameter : ChangedParameters)
+	{
+		OnParameterChangedDelegate.Broadcast(ChangedParameter);
+	}
 }
 
 void UAmbiverseParameterManager::SetParameterValue(UAmbiverseParameter* Parameter, const float Value)
 {
-	if (ParameterRegistry.IsEmpty())
+	if (!Parameter) { return; }
+
+	SetParameterValueAtIndex(RegisterParameter(Parameter), Value);
+}
+
+void UAmbiverseParameterManager::SetParameters(TArrayView<const FAmbiverseParameterHandle> Handles, TArrayView<const float> Values)
+{
+	if (Handles.Num() != Values.Num())
 	{
-		RegisterParameter(Parameter);
+		UE_LOG(LogAmbiverseParameterManager, Warning, TEXT("SetParameters: %d handles were provided with %d values."), Handles.Num(), Values.Num());
+		return;
 	}
 
-	for (UAmbiverseParameter* AmbiverseParameter : ParameterRegistry)
+	for (int32 Index {0}; Index < Handles.Num(); ++Index)
 	{
-		if (AmbiverseParameter == Parameter)
-		{
-			AmbiverseParameter->SetParameter(Value);
-			break;
-		}
+		SetParameterValueAtIndex(Handles[Index].Index, Values[Index]);
 	}
+}
+
+void UAmbiverseParameterManager::RegisterBindingComponent(UAmbiverseParameterBindingComponent* BindingComponent)
+{
+	if (!BindingComponent) { return; }
+	BindingComponents.AddUnique(BindingComponent);
+}
+
+void UAmbiverseParameterManager::UnregisterBindingComponent(UAmbiverseParameterBindingComponent* BindingComponent)
+{
+	BindingComponents.RemoveSwap(BindingComponent);
+}
 
-	OnParameterChangedDelegate.Broadcast(Parameter);
+FAmbiverseParameterHandle UAmbiverseParameterManager::GetParameterHandle(UAmbiverseParameter* Parameter)
+{
+	FAmbiverseParameterHandle Handle;
+	Handle.Index = RegisterParameter(Parameter);
+	return Handle;
 }
 
-void UAmbiverseParameterManager::RegisterParameter(UAmbiverseParameter* Parameter)
+void UAmbiverseParameterManager::SetParameterValueAtIndex(const int32 Index, const float Value)
 {
+	if (!ParameterRegistry.IsValidIndex(Index))
+	{
+		UE_LOG(LogAmbiverseParameterManager, Warning, TEXT("SetParameterValueAtIndex: Invalid parameter handle: %d."), Index);
+		return;
+	}
+	
+	UAmbiverseParameter* Parameter {ParameterRegistry[Index]};
 	if (!Parameter) { return; }
-	if (!IsParameterRegistered(Parameter))
+	
+	FParameterState& State {ParameterStates[Index]};
+	State.TargetValue = Parameter->GetNormalizedValue(Value);
+
+	if (Parameter->Smoothing == EAmbiverseParameterSmoothing::None && Parameter->ParameterValue != State.TargetValue)
 	{
-		ParameterRegistry.Add(Parameter);
-		UE_LOG(LogAmbiverseParameterManager, Verbose, TEXT("Registered parameter: '%s'"), *Parameter->GetName())
+		Parameter->ParameterValue = State.TargetValue;
+		DirtyParameters[Index] = true;
 	}
+	
+	TRACE_AMBIVERSE_PARAMETER_CHANGED(Parameter, Value);
 }
 
-bool UAmbiverseParameterManager::IsParameterRegistered(const UAmbiverseParameter* Parameter) const
+int32 UAmbiverseParameterManager::RegisterParameter(UAmbiverseParameter* Parameter)
 {
-	if (!Parameter) { return false; }
-	if (ParameterRegistry.Contains(Parameter))
+	if (!Parameter) { return INDEX_NONE; }
+	if (const int32* Index {ParameterIndices.Find(Parameter)})
 	{
-		return true;
+		return *Index;
 	}
-	return false;
+	
+	const int32 Index {ParameterRegistry.Add(Parameter)};
+	ParameterIndices.Add(Parameter, Index);
+	
+	FParameterState& State {ParameterStates.AddDefaulted_GetRef()};
+	State.TargetValue = Parameter->ParameterValue;
+	DirtyParameters.Add(false);
+	
+	UE_LOG(LogAmbiverseParameterManager, Verbose, TEXT("Registered parameter: '%s'"), *Parameter->GetName())
+	return Index;
+}
+
+bool UAmbiverseParameterManager::IsParameterRegistered(const UAmbiverseParameter* Parameter) const
+{
+	if (!Parameter) { return false; }
+	return ParameterIndices.Contains(Parameter);
 }
 
 void UAmbiverseParameterManager::HandleOnLayerRegistered(UAmbiverseLayer* RegisteredLayer)
@@ -111,17 +219,25 @@ void UAmbiverseParameterManager::HandleOnLayerRegistered(UAmbiverseLayer* Regist
 		RequiredParameters.AddUnique(ParameterModifiers.Parameter);
 	}
 
-	// for (FAmbiverseProceduralElement ProceduralSoundData : RegisteredLayer->ProceduralSounds)
-	// {
-	// 	for (FAmbiverseParameterModifiers& ParameterModifiers : ProceduralSoundData.Parameters)
-	// 	{
-	// 		RequiredParameters.AddUnique(ParameterModifiers.Parameter);
-	// 	}
-	// }
+	for (const FAmbiverseProceduralElement& ProceduralElement : RegisteredLayer->ProceduralElements)
+	{
+		for (const FAmbiverseParameterModifiers& ParameterModifiers : ProceduralElement.Parameters)
+		{
+			RequiredParameters.AddUnique(ParameterModifiers.Parameter);
+		}
+	}
+
+	/** The compiled layer is built before the layer is registered, and may hold parameters of a cooked layout. */
+	for (UAmbiverseParameter* CompiledParameter : RegisteredLayer->GetCompiledLayer().GetParameters())
+	{
+		RequiredParameters.AddUnique(CompiledParameter);
+	}
 
 	for (UAmbiverseParameter* RequiredParameter : RequiredParameters)
 	{
-		if (!ParameterRegistry.Contains(RequiredParameter))
+		if (!RequiredParameter) { continue; }
+		
+		if (!IsParameterRegistered(RequiredParameter))
 		{
 			RegisterParameter(RequiredParameter);
 			UE_LOG(LogAmbiverseParameterManager, Verbose, TEXT("Registered parameter: '%s'"), *RequiredParameter->GetName());
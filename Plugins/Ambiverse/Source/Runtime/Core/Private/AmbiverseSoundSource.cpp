@@ -1,7 +1,10 @@
 // Copyright (c) 2023-present Tim Verberne. All rights reserved.
 
 #include "AmbiverseSoundSource.h"
+#include "AmbiverseElement.h"
+#include "AmbiverseParameter.h"
 #include "AmbiverseSoundSourceManager.h"
+#include "AudioParameter.h"
 
 #if !UE_BUILD_SHIPPING
 #include "Kismet/GameplayStatics.h"
@@ -43,6 +46,15 @@ void AAmbiverseSoundSource::Initialize(UAmbiverseSoundSourceManager* Manager,
 	SetVolume(SoundSourceData.Volume);
 	SoundSourceName = SoundSourceData.Name;
 	AmbiverseLayer = SoundSourceData.Layer;
+	AmbiverseElement = SoundSourceData.Element;
+
+	/** The current values are set before the sound starts, so it doesn't play its first block with the default inputs.
+	 *	Pooled sound sources may still hold the parameters of the previous element. */
+	if (AudioComponent)
+	{
+		AudioComponent->ResetParameters();
+	}
+	ForwardParameters();
 
 	if(AudioComponent)
 	{
@@ -54,6 +66,32 @@ void AAmbiverseSoundSource::Initialize(UAmbiverseSoundSourceManager* Manager,
 	}
 }
 
+void AAmbiverseSoundSource::FadeOut(const float Duration)
+{
+	if (!AudioComponent) { return; }
+
+	if (Duration > 0.0f)
+	{
+		AudioComponent->FadeOut(Duration, 0.0f);
+	}
+	else
+	{
+		AudioComponent->Stop();
+	}
+}
+
+void AAmbiverseSoundSource::ForwardParameters(const TArray<UAmbiverseParameter*>* ChangedParameters)
+{
+	if (!AudioComponent || !AmbiverseElement || AmbiverseElement->ForwardedParameters.IsEmpty()) { return; }
+
+	TArray<FAudioParameter> AudioParameters;
+	AmbiverseElement->GetForwardedParameters(AudioParameters, ChangedParameters);
+
+	if (AudioParameters.IsEmpty()) { return; }
+	
+	AudioComponent->SetParameters(MoveTemp(AudioParameters));
+}
+
 void AAmbiverseSoundSource::BeginPlay()
 {
 	Super::BeginPlay();
@@ -61,11 +99,19 @@ void AAmbiverseSoundSource::BeginPlay()
 	if(AudioComponent)
 	{
 		AudioComponent->OnAudioFinished.AddDynamic(this, &AAmbiverseSoundSource::HandleOnAudioFinishedPlaying);
+		AudioComponent->OnAudioVirtualizationChanged.AddDynamic(this, &AAmbiverseSoundSource::HandleOnAudioVirtualizationChanged);
 	}
 }
 
+void AAmbiverseSoundSource::HandleOnAudioVirtualizationChanged(bool IsVirtualized)
+{
+	IsSoundVirtualized = IsVirtualized;
+}
+
 void AAmbiverseSoundSource::HandleOnAudioFinishedPlaying()
 {
+	IsSoundVirtualized = false;
+	
 	if (SoundSourceManager)
 	{
 #if !UE_BUILD_SHIPPING
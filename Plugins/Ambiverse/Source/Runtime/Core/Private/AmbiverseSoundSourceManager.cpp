@@ -1,11 +1,39 @@
 // Copyright (c) 2023-present Tim Verberne. All rights reserved.
 
 #include "AmbiverseSoundSourceManager.h"
+#include "AmbiverseParameterManager.h"
 #include "AmbiverseSoundSource.h"
+#include "AmbiverseStats.h"
 #include "AmbiverseSubsystem.h"
+#include "AmbiverseTrace.h"
 
 DEFINE_LOG_CATEGORY_CLASS(UAmbiverseSoundSourceManager, LogAmbiverseSoundSourceManager);
 
+void UAmbiverseSoundSourceManager::Tick(const float DeltaTime)
+{
+	if (!Owner) { return; }
+
+	ForwardParameters();
+}
+
+void UAmbiverseSoundSourceManager::ForwardParameters()
+{
+	const UAmbiverseParameterManager* ParameterManager {Owner->GetParameterManager()};
+	if (!ParameterManager) { return; }
+
+	/** The parameter manager has already integrated this tick's values, so each voice receives at most one batch per tick. */
+	const TArray<UAmbiverseParameter*>& ChangedParameters {ParameterManager->GetChangedParameters()};
+	if (ChangedParameters.IsEmpty()) { return; }
+
+	AMBIVERSE_TRACE_SCOPE(AmbiverseForwardParameters);
+	
+	for (AAmbiverseSoundSource* SoundSource : ActiveSoundSources)
+	{
+		if (!SoundSource) { continue; }
+		SoundSource->ForwardParameters(&ChangedParameters);
+	}
+}
+
 void UAmbiverseSoundSourceManager::InitiateSoundSource(FAmbiverseSoundSourceData& SoundSourceData)
 {
 	if (!SoundSourceData.Sound)
@@ -13,43 +41,95 @@ void UAmbiverseSoundSourceManager::InitiateSoundSource(FAmbiverseSoundSourceData
 		UE_LOG(LogAmbiverseSoundSourceManager, Warning, TEXT("InitiateSoundSource: SoundSourceData contains no valid sound."))
 		return;
 	}
-	AAmbiverseSoundSource* SoundSourceInstance {nullptr};
+
+	bool IsSpawned {false};
+	AAmbiverseSoundSource* SoundSourceInstance {AcquireSoundSource(IsSpawned)};
+
+	/** A request that could not be served from the pool is a pool miss, whether or not a new sound source could be spawned. */
+	if (IsSpawned || !SoundSourceInstance)
+	{
+		++Owner->GetFrameCounters().PoolMisses;
+	}
 	
-	if (Pool.Num() == 0)
+	if (!SoundSourceInstance)
 	{
-		SoundSourceInstance = Owner->GetWorld()->SpawnActor<AAmbiverseSoundSource>(AAmbiverseSoundSource::StaticClass());
-		UE_LOG(LogAmbiverseSoundSourceManager, Verbose, TEXT("InitiateSoundSource: Created new SoundSource instance."))
+		UE_LOG(LogAmbiverseSoundSourceManager, Warning, TEXT("InitiateSoundSource: Unable to acquire a SoundSource for '%s'."), *SoundSourceData.Name.ToString())
+		TRACE_AMBIVERSE_VOICE_REQUEST(SoundSourceData, EAmbiverseTraceVoiceResult::Dropped);
+		return;
 	}
-	else
+
+	TRACE_AMBIVERSE_VOICE_REQUEST(SoundSourceData, IsSpawned ? EAmbiverseTraceVoiceResult::Spawned : EAmbiverseTraceVoiceResult::Pooled);
+	
+	SoundSourceInstance->Initialize(this, SoundSourceData);
+	ActiveSoundSources.AddUnique(SoundSourceInstance);
+}
+
+AAmbiverseSoundSource* UAmbiverseSoundSourceManager::AcquireSoundSource(bool& IsSpawned)
+{
+	IsSpawned = false;
+	
 	{
-		for (AAmbiverseSoundSource* SoundSource : Pool)
-		{
-			SoundSourceInstance = SoundSource;
-			break;
-		}
+		SCOPE_CYCLE_COUNTER(STAT_AmbiversePoolAcquire);
 		
-		if (!SoundSourceInstance)
+		while (!Pool.IsEmpty())
 		{
-			SoundSourceInstance = Owner->GetWorld()->SpawnActor<AAmbiverseSoundSource>(AAmbiverseSoundSource::StaticClass());
-			UE_LOG(LogAmbiverseSoundSourceManager, Verbose, TEXT("InitiateSoundSource: Created new SoundSource instance."))
+			AAmbiverseSoundSource* SoundSource {Pool.Pop(false)};
+			if (IsValid(SoundSource))
+			{
+				return SoundSource;
+			}
 		}
 	}
-	if (SoundSourceInstance)
-	{
-		SoundSourceInstance->Initialize(this, SoundSourceData);
-		ActiveSoundSources.AddUnique(SoundSourceInstance);
-	}
+
+	SCOPE_CYCLE_COUNTER(STAT_AmbiverseActorSpawn);
+	
+	AAmbiverseSoundSource* SoundSource {Owner->GetWorld()->SpawnActor<AAmbiverseSoundSource>(AAmbiverseSoundSource::StaticClass())};
+	if (!SoundSource) { return nullptr; }
+	
+	++Owner->GetFrameCounters().Spawns;
+	IsSpawned = true;
+	
+	UE_LOG(LogAmbiverseSoundSourceManager, Verbose, TEXT("AcquireSoundSource: Created new SoundSource instance."))
+	return SoundSource;
 }
 
 void UAmbiverseSoundSourceManager::ReleaseToPool(AAmbiverseSoundSource* SoundSource)
 {
 	if (!SoundSource) { return; }
 
-	ActiveSoundSources.Remove(SoundSource);
+	ActiveSoundSources.RemoveSwap(SoundSource);
 	
 	Pool.AddUnique(SoundSource);
 }
 
+void UAmbiverseSoundSourceManager::ReleaseLayerSoundSources(const UAmbiverseLayer* Layer, const float FadeOutDuration)
+{
+	if (!Layer) { return; }
+
+	/** Stopping a sound can release its sound source immediately, which modifies the active sound sources. */
+	const TArray<AAmbiverseSoundSource*> SoundSources {ActiveSoundSources};
+	for (AAmbiverseSoundSource* SoundSource : SoundSources)
+	{
+		if (SoundSource && SoundSource->GetLayer() == Layer)
+		{
+			SoundSource->FadeOut(FadeOutDuration);
+		}
+	}
+}
+
+int32 UAmbiverseSoundSourceManager::GetVirtualSoundSourceCount() const
+{
+	int32 Count {0};
+	for (const AAmbiverseSoundSource* SoundSource : ActiveSoundSources)
+	{
+		if (SoundSource && SoundSource->IsVirtualized())
+		{
+			++Count;
+		}
+	}
+	return Count;
+}
+
 #if !UE_BUILD_SHIPPING
 void UAmbiverseSoundSourceManager::SetSoundSourceVisualisationEnabled(const bool IsEnabled)
 {
@@ -0,0 +1,29 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseStats.h"
+
+CSV_DEFINE_CATEGORY_MODULE(AMBIVERSE_API, Ambiverse, true);
+
+DEFINE_STAT(STAT_AmbiverseSubsystemTick);
+DEFINE_STAT(STAT_AmbiverseLayerTick);
+DEFINE_STAT(STAT_AmbiverseParameterEvaluation);
+DEFINE_STAT(STAT_AmbiverseSoundSelection);
+DEFINE_STAT(STAT_AmbiverseDistribution);
+DEFINE_STAT(STAT_AmbiverseTracing);
+DEFINE_STAT(STAT_AmbiversePoolAcquire);
+DEFINE_STAT(STAT_AmbiverseActorSpawn);
+
+DEFINE_STAT(STAT_AmbiverseActiveLayers);
+DEFINE_STAT(STAT_AmbiverseScheduledEvents);
+DEFINE_STAT(STAT_AmbiverseFiresPerSecond);
+DEFINE_STAT(STAT_AmbiverseActiveVoices);
+DEFINE_STAT(STAT_AmbiverseVirtualVoices);
+DEFINE_STAT(STAT_AmbiversePooledVoices);
+DEFINE_STAT(STAT_AmbiverseBedVoices);
+DEFINE_STAT(STAT_AmbiverseFarFieldVoices);
+
+DEFINE_STAT(STAT_AmbiverseFires);
+DEFINE_STAT(STAT_AmbiverseSpawns);
+DEFINE_STAT(STAT_AmbiversePoolMisses);
+DEFINE_STAT(STAT_AmbiverseTraces);
+DEFINE_STAT(STAT_AmbiverseDeferredEvents);
@@ -2,19 +2,49 @@
 
 #include "AmbiverseSubsystem.h"
 #include "AmbiverseDistributor.h"
+#include "AmbiverseBedManager.h"
 #include "AmbiverseDistributorManager.h"
+#include "AmbiverseFarFieldManager.h"
 #include "AmbiverseElement.h"
 #include "AmbiverseLayer.h"
 #include "AmbiverseLayerManager.h"
 #include "AmbiverseParameterManager.h"
 #include "AmbiverseSoundSourceData.h"
 #include "AmbiverseSoundSourceManager.h"
+#include "AmbiverseSpawnPointTable.h"
+#include "AmbiverseTrace.h"
 #include "AmbiverseVisualisationComponent.h"
 
 DEFINE_LOG_CATEGORY_CLASS(UAmbiverseSubsystem, LogAmbiverseSubsystem);
 
+static TAutoConsoleVariable<float> CVarListenerDensityExponent(
+	TEXT("av.Listeners.DensityExponent"), 0.5f,
+	TEXT("Controls how the density of shared layers scales with the number of listeners. The density is multiplied by ListenerCount ^ Exponent.\n")
+	TEXT("0 keeps the total number of sounds constant, 1 gives every listener the full density."));
+
+static TAutoConsoleVariable<float> CVarStatsSmoothingTime(
+	TEXT("av.Stats.SmoothingTime"), 1.0f,
+	TEXT("The time constant in seconds used to smooth the fires per second counter."));
+
+static TAutoConsoleVariable<int32> CVarSchedulerSeed(
+	TEXT("av.Scheduler.Seed"), 0,
+	TEXT("The seed of the random stream used to schedule procedural elements. 0 uses a different seed every session."));
+
+static FAutoConsoleCommandWithWorld DumpStatsCommand(
+	TEXT("av.DumpStats"),
+	TEXT("Logs the Ambiverse counters of the last tick. Useful in builds or sessions without the stats system."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](const UWorld* World)
+	{
+		const UAmbiverseSubsystem* Subsystem {World ? World->GetSubsystem<UAmbiverseSubsystem>() : nullptr};
+		if (!Subsystem) { return; }
+
+		Subsystem->DumpStats();
+	}));
+
 UAmbiverseSubsystem::UAmbiverseSubsystem()
 {
+	/** There is always a primary listener, even if it is not valid. */
+	Listeners.AddDefaulted();
 }
 
 void UAmbiverseSubsystem::Initialize(FSubsystemCollectionBase& Collection)
@@ -33,9 +63,29 @@ void UAmbiverseSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 	DistributorManager = NewObject<UAmbiverseDistributorManager>(this);
 	if (DistributorManager) { DistributorManager->Initialize(this); }
 
+	BedManager = NewObject<UAmbiverseBedManager>(this);
+	if (BedManager) { BedManager->Initialize(this); }
+
+	FarFieldManager = NewObject<UAmbiverseFarFieldManager>(this);
+	if (FarFieldManager) { FarFieldManager->Initialize(this); }
+
 #if !UE_BUILD_SHIPPING
 	VisualisationComponent.Reset(NewObject<UAmbiverseVisualisationComponent>(this));
 #endif
+
+	const int32 Seed {CVarSchedulerSeed.GetValueOnGameThread()};
+	if (Seed != 0)
+	{
+		RandomStream.Initialize(Seed);
+	}
+	else
+	{
+		RandomStream.GenerateNewSeed();
+	}
+
+	/** Generate the spawn point tables up front, so the first procedural element doesn't cause a hitch. */
+	FAmbiverseSpawnPointTable::GetBoxTable();
+	FAmbiverseSpawnPointTable::GetAnnulusTable();
 }
 
 void UAmbiverseSubsystem::OnWorldBeginPlay(UWorld& InWorld)
@@ -49,84 +99,359 @@ void UAmbiverseSubsystem::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	CSV_SCOPED_TIMING_STAT(Ambiverse, SubsystemTick);
+
+	FrameCounters.Reset();
+
+	UpdateListenerStates();
+
+	/** Parameters are integrated once per tick, before any layer evaluates its modifiers. */
+	if (ParameterManager && ParameterManager->IsInitialized)
+	{
+		ParameterManager->Tick(DeltaTime);
+	}
+
+	/** The distributors receive the listener state before any procedural elements are processed. */
+	if (DistributorManager && DistributorManager->IsInitialized)
+	{
+		DistributorManager->Tick(DeltaTime);
+	}
+
+	/** Queued sound sources are started before new ones are initiated by the layers. */
+	if (SoundSourceManager && SoundSourceManager->IsInitialized)
+	{
+		SoundSourceManager->Tick(DeltaTime);
+	}
+
 	if (LayerManager && LayerManager->IsInitialized)
 	{
+		const double LayerTickStartTime {FPlatformTime::Seconds()};
 		LayerManager->Tick(DeltaTime);
+		FrameCounters.LayerTickTime = static_cast<float>((FPlatformTime::Seconds() - LayerTickStartTime) * 1000.0);
+	}
+
+	/** Beds follow the fades of their layers, so they are updated after the layers. */
+	if (BedManager && BedManager->IsInitialized)
+	{
+		BedManager->Tick(DeltaTime);
+	}
+
+	if (FarFieldManager && FarFieldManager->IsInitialized)
+	{
+		FarFieldManager->Tick(DeltaTime);
 	}
+
+	UpdateStats(DeltaTime);
 }
 
-void UAmbiverseSubsystem::ProcessProceduralElement(UAmbiverseLayer* Layer, FAmbiverseProceduralElement& ProceduralElement)
+void UAmbiverseSubsystem::UpdateStats(const float DeltaTime)
 {
-	if (!Layer)
+	/** Voices that are not sound source actors are sampled once every component has ticked. */
+	if (BedManager)
 	{
-		UE_LOG(LogAmbiverseSubsystem, Error, TEXT("ProcessProceduralElement: Layer is nullptr."));
-		return;
+		FrameCounters.BedVoices = BedManager->GetBedVoiceCount();
+	}
+	if (FarFieldManager)
+	{
+		FrameCounters.FarFieldVoices = FarFieldManager->GetFarFieldVoiceCount();
 	}
 	
-	ProceduralElement.ReferenceTime = FMath::RandRange(ProceduralElement.IntervalRange.X,
-	                                                   ProceduralElement.IntervalRange.Y);
+	LastFrameCounters = FrameCounters;
 
-	float DensityModifier {1.0f};
-	float VolumeModifier {1.0f};
+	if (DeltaTime > 0.0f)
+	{
+		const float Alpha {1.0f - FMath::Exp(-DeltaTime / FMath::Max(CVarStatsSmoothingTime.GetValueOnGameThread(), UE_SMALL_NUMBER))};
+		FiresPerSecond = FMath::Lerp(FiresPerSecond, FrameCounters.Fires / DeltaTime, Alpha);
+	}
 
-	if (!ParameterManager)
+	SET_FLOAT_STAT(STAT_AmbiverseFiresPerSecond, FiresPerSecond);
+	SET_DWORD_STAT(STAT_AmbiverseFires, FrameCounters.Fires);
+	SET_DWORD_STAT(STAT_AmbiverseSpawns, FrameCounters.Spawns);
+	SET_DWORD_STAT(STAT_AmbiversePoolMisses, FrameCounters.PoolMisses);
+	SET_DWORD_STAT(STAT_AmbiverseTraces, FrameCounters.Traces);
+	SET_DWORD_STAT(STAT_AmbiverseDeferredEvents, FrameCounters.DeferredEvents);
+	SET_DWORD_STAT(STAT_AmbiverseBedVoices, FrameCounters.BedVoices);
+	SET_DWORD_STAT(STAT_AmbiverseFarFieldVoices, FrameCounters.FarFieldVoices);
+
+	if (LayerManager)
 	{
-		UE_LOG(LogAmbiverseSubsystem, Error, TEXT("ProcessProceduralElement: ParameterManager is nullptr."));
-		return;
+		SET_DWORD_STAT(STAT_AmbiverseActiveLayers, LayerManager->GetActiveLayerCount());
+		SET_DWORD_STAT(STAT_AmbiverseScheduledEvents, LayerManager->GetScheduledEventCount());
 	}
+
+	if (SoundSourceManager)
+	{
+		SET_DWORD_STAT(STAT_AmbiverseActiveVoices, SoundSourceManager->GetActiveSoundSourceCount());
+		SET_DWORD_STAT(STAT_AmbiverseVirtualVoices, SoundSourceManager->GetVirtualSoundSourceCount());
+		SET_DWORD_STAT(STAT_AmbiversePooledVoices, SoundSourceManager->GetPooledSoundSourceCount());
+	}
+
+#if CSV_PROFILER
+	/** Long captures with -csvprofile chart these per frame, so they are recorded even when the stats system is disabled. */
+	CSV_CUSTOM_STAT(Ambiverse, LayerTickTime, FrameCounters.LayerTickTime, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Ambiverse, Fires, FrameCounters.Fires, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Ambiverse, Spawns, FrameCounters.Spawns, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Ambiverse, PoolMisses, FrameCounters.PoolMisses, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Ambiverse, Traces, FrameCounters.Traces, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Ambiverse, DeferredEvents, FrameCounters.DeferredEvents, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Ambiverse, BedVoices, FrameCounters.BedVoices, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Ambiverse, FarFieldVoices, FrameCounters.FarFieldVoices, ECsvCustomStatOp::Set);
+
+	if (SoundSourceManager)
+	{
+		CSV_CUSTOM_STAT(Ambiverse, ActiveVoices, SoundSourceManager->GetActiveSoundSourceCount(), ECsvCustomStatOp::Set);
+	}
+#endif
+}
+
+void UAmbiverseSubsystem::DumpStats() const
+{
+	const FAmbiverseFrameCounters& Counters {LastFrameCounters};
+
+	UE_LOG(LogAmbiverseSubsystem, Log, TEXT("DumpStats: Layers: %d, Scheduled: %d, Fires/s: %.2f, Fires: %d, Spawns: %d, PoolMisses: %d, Traces: %d, Deferred: %d, LayerTick: %.3f ms"),
+		LayerManager ? LayerManager->GetActiveLayerCount() : 0, LayerManager ? LayerManager->GetScheduledEventCount() : 0,
+		FiresPerSecond, Counters.Fires, Counters.Spawns, Counters.PoolMisses, Counters.Traces, Counters.DeferredEvents, Counters.LayerTickTime);
+
+	if (SoundSourceManager)
+	{
+		UE_LOG(LogAmbiverseSubsystem, Log, TEXT("DumpStats: Voices: %d active, %d virtual, %d pooled"),
+			SoundSourceManager->GetActiveSoundSourceCount(), SoundSourceManager->GetVirtualSoundSourceCount(),
+			SoundSourceManager->GetPooledSoundSourceCount());
+	}
+
+	UE_LOG(LogAmbiverseSubsystem, Log, TEXT("DumpStats: Beds: %d, %d voices, FarField: %d voices"),
+		BedManager ? BedManager->GetBedCount() : 0, Counters.BedVoices, Counters.FarFieldVoices);
+}
+
+void UAmbiverseSubsystem::UpdateListenerStates()
+{
+	AMBIVERSE_TRACE_SCOPE(AmbiverseUpdateListenerStates);
+	
+	const TWeakObjectPtr<AActor> PreviousViewTarget {Listeners[0].ViewTarget};
+	
+	Listeners.Reset();
+
+	for (FConstPlayerControllerIterator Iterator {GetWorld()->GetPlayerControllerIterator()}; Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController {Iterator->Get()};
+		if (!PlayerController || !PlayerController->IsLocalController()) { continue; }
+		
+		if (const APlayerCameraManager* CameraManager {PlayerController->PlayerCameraManager})
+		{
+			FAmbiverseListenerState& ListenerState {Listeners.AddDefaulted_GetRef()};
+			ListenerState.Location = CameraManager->GetCameraLocation();
+			ListenerState.Rotation = CameraManager->GetCameraRotation();
+			ListenerState.ViewTarget = CameraManager->GetViewTarget();
+			ListenerState.IsValid = true;
+			
+			if (const AActor* ViewTarget {ListenerState.ViewTarget.Get()})
+			{
+				ListenerState.Velocity = ViewTarget->GetVelocity();
+			}
+		}
+	}
+
+	ExternalListeners.RemoveAll([](const TWeakObjectPtr<AActor>& Listener) { return !Listener.IsValid(); });
+	
+	for (const TWeakObjectPtr<AActor>& ExternalListener : ExternalListeners)
+	{
+		FAmbiverseListenerState& ListenerState {Listeners.AddDefaulted_GetRef()};
+		ExternalListener->GetActorEyesViewPoint(ListenerState.Location, ListenerState.Rotation);
+		ListenerState.Velocity = ExternalListener->GetVelocity();
+		ListenerState.ViewTarget = ExternalListener;
+		ListenerState.IsValid = true;
+	}
+
+	if (Listeners.IsEmpty())
+	{
+		Listeners.AddDefaulted();
+	}
+
+	if (Listeners[0].ViewTarget != PreviousViewTarget)
+	{
+		UE_LOG(LogAmbiverseSubsystem, Verbose, TEXT("UpdateListenerStates: View target changed to '%s'."),
+			Listeners[0].ViewTarget.IsValid() ? *Listeners[0].ViewTarget->GetName() : TEXT("None"));
+		
+		OnListenerViewTargetChanged.Broadcast(Listeners[0].ViewTarget.Get());
+	}
+}
+
+void UAmbiverseSubsystem::SetRandomSeed(const int32 Seed)
+{
+	RandomStream.Initialize(Seed);
+	UE_LOG(LogAmbiverseSubsystem, Verbose, TEXT("SetRandomSeed: Scheduler seed set to %d."), Seed);
+}
+
+void UAmbiverseSubsystem::SetSimulationMode(const bool IsEnabled)
+{
+	IsSimulating = IsEnabled;
+	UE_LOG(LogAmbiverseSubsystem, Verbose, TEXT("SetSimulationMode: Simulation mode %s."), IsEnabled ? TEXT("enabled") : TEXT("disabled"));
+}
+
+void UAmbiverseSubsystem::RegisterListener(AActor* Listener)
+{
+	if (!Listener) { return; }
 	
-	ParameterManager->GetScalarsForElement(DensityModifier, VolumeModifier, Layer, ProceduralElement);
+	ExternalListeners.AddUnique(Listener);
+	UE_LOG(LogAmbiverseSubsystem, Verbose, TEXT("RegisterListener: Registered listener '%s'."), *Listener->GetName());
+}
 
-	ProceduralElement.Time = ProceduralElement.ReferenceTime * DensityModifier;
+void UAmbiverseSubsystem::UnregisterListener(AActor* Listener)
+{
+	if (!Listener) { return; }
+	
+	ExternalListeners.Remove(Listener);
+	UE_LOG(LogAmbiverseSubsystem, Verbose, TEXT("UnregisterListener: Unregistered listener '%s'."), *Listener->GetName());
+}
 
-	/** We try to get the location of the listener here.*/
-	FVector CameraLocation;
-	bool IsCameraValid {false};
+int32 UAmbiverseSubsystem::SelectListener(const UAmbiverseLayer* Layer, FAmbiverseProceduralElement& ProceduralElement,
+	const TArray<FAmbiverseListenerState>& ListenerStates) const
+{
+	const int32 OwningListenerIndex {LayerManager ? LayerManager->GetOwningListenerIndex(Layer) : INDEX_NONE};
+	if (OwningListenerIndex != INDEX_NONE)
+	{
+		return ListenerStates.IsValidIndex(OwningListenerIndex) ? OwningListenerIndex : INDEX_NONE;
+	}
+
+	/** Shared layers take turns between listeners, so the events of a layer are shared instead of duplicated for every listener.
+	 *	Sounds are placed relative to the selected listener, so there is no location to find the nearest listener for until after placement. */
+	ProceduralElement.ListenerCursor = (ProceduralElement.ListenerCursor + 1) % ListenerStates.Num();
+	return ProceduralElement.ListenerCursor;
+}
 
-	if (APlayerController* PlayerController {GetWorld()->GetFirstPlayerController()})
+float UAmbiverseSubsystem::GetListenerDensityScalar(const UAmbiverseLayer* Layer) const
+{
+	if (!Layer || Listeners.Num() <= 1) { return 1.0f; }
+	if (LayerManager && LayerManager->GetOwningListenerIndex(Layer) != INDEX_NONE) { return 1.0f; }
+
+	return FMath::Pow(static_cast<float>(Listeners.Num()), CVarListenerDensityExponent.GetValueOnGameThread());
+}
+
+bool UAmbiverseSubsystem::IsAudibleToAnyListener(const TArray<FAmbiverseListenerState>& ListenerStates, const FVector& Location,
+	const float MaxDistance)
+{
+	const double MaxDistanceSquared {FMath::Square(static_cast<double>(MaxDistance))};
+	
+	for (const FAmbiverseListenerState& ListenerState : ListenerStates)
 	{
-		if (const APlayerCameraManager* CameraManager{PlayerController->PlayerCameraManager})
+		if (ListenerState.IsValid && FVector::DistSquared(ListenerState.Location, Location) <= MaxDistanceSquared)
 		{
-			CameraLocation = CameraManager->GetCameraLocation();
-			IsCameraValid = true;
+			return true;
 		}
 	}
+	
+	return false;
+}
+
+void UAmbiverseSubsystem::ProcessProceduralElement(UAmbiverseLayer* Layer, const int32 ElementIndex, const TArray<FAmbiverseListenerState>& ListenerStates)
+{
+	if (!Layer)
+	{
+		UE_LOG(LogAmbiverseSubsystem, Error, TEXT("ProcessProceduralElement: Layer is nullptr."));
+		return;
+	}
 
-	if (!IsCameraValid)
+	if (!Layer->ProceduralElements.IsValidIndex(ElementIndex))
+	{
+		UE_LOG(LogAmbiverseSubsystem, Error, TEXT("ProcessProceduralElement: Element index %d is out of range."), ElementIndex);
+		return;
+	}
+
+	FAmbiverseProceduralElement& ProceduralElement {Layer->ProceduralElements[ElementIndex]};
+
+	AMBIVERSE_TRACE_SCOPE(AmbiverseProcessProceduralElement);
+
+	++FrameCounters.Fires;
+
+	/** The time by which the element overshot its scheduled time. */
+	const float DeferralLatency {FMath::Max(0.0f, -ProceduralElement.Time)};
+
+	OnElementFired.Broadcast(Layer, ProceduralElement, DeferralLatency);
+	
+	SetNewTimeForProceduralElement(Layer, ElementIndex);
+
+	/** In simulation mode, only the schedule is evaluated. */
+	if (IsSimulating) { return; }
+
+	const int32 ListenerIndex {SelectListener(Layer, ProceduralElement, ListenerStates)};
+	if (ListenerIndex == INDEX_NONE || !ListenerStates[ListenerIndex].IsValid)
 	{
 		UE_LOG(LogAmbiverseSubsystem, Error, TEXT("ProcessProceduralElement: Unable to obtain valid camera location."));
 		return;
 	}
 
+	const FAmbiverseListenerState& Listener {ListenerStates[ListenerIndex]};
+
 	/** Prepare the sound source data. */
 	FAmbiverseSoundSourceData SoundSourceData{FAmbiverseSoundSourceData()};
 
-	SoundSourceData.Sound = UAmbiverseElement::GetSoundFromMap(ProceduralElement.Element->Sounds);
-	SoundSourceData.Volume = ProceduralElement.Element->Volume;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_AmbiverseSoundSelection);
+		/** Compiled layers select variants from an alias table. */
+		const FAmbiverseCompiledLayer& CompiledLayer {Layer->GetCompiledLayer()};
+		
+		if (CompiledLayer.GetIsCompiled() && ElementIndex < CompiledLayer.GetElementCount())
+		{
+			SoundSourceData.Sound = CompiledLayer.SelectSound(ElementIndex, RandomStream);
+		}
+		else
+		{
+			SoundSourceData.Sound = UAmbiverseElement::GetSoundFromMap(ProceduralElement.Element->Sounds);
+		}
+	}
+	SoundSourceData.Volume = ProceduralElement.Element->Volume * Layer->GetLifetimeVolumeScalar() * Layer->TransitionFade;
 	SoundSourceData.Name = FName(ProceduralElement.Element->GetName());
 	SoundSourceData.Layer = Layer;
+	SoundSourceData.Element = ProceduralElement.Element;
+
+	/** Sounds are placed around the point the listener is expected to pass during the lifetime of the sound. */
+	const float SoundDuration {SoundSourceData.Sound ? SoundSourceData.Sound->GetDuration() : 0.0f};
+	const FVector CameraLocation {Listener.Location + FAmbiverseSoundDistributionData::GetPredictionOffset(
+		ProceduralElement.Element->DistributionData, Listener.Velocity, SoundDuration)};
 
-	if (const TSubclassOf<UAmbiverseDistributor> DistributorClass{ProceduralElement.Element->DistributorClass})
 	{
-		if (!DistributorManager)
+		SCOPE_CYCLE_COUNTER(STAT_AmbiverseDistribution);
+		AMBIVERSE_TRACE_SCOPE(AmbiverseDistribution);
+		
+		if (const TSubclassOf<UAmbiverseDistributor> DistributorClass{ProceduralElement.Element->DistributorClass})
 		{
-			UE_LOG(LogAmbiverseSubsystem, Error, TEXT("ProcessProceduralElement: DistributorManager is nullptr."));
-			return;
-		}
+			if (!DistributorManager)
+			{
+				UE_LOG(LogAmbiverseSubsystem, Error, TEXT("ProcessProceduralElement: DistributorManager is nullptr."));
+				return;
+			}
 
-		if (UAmbiverseDistributor* Distributor{DistributorManager->GetDistributorByClass(DistributorClass)})
-		{
-			FTransform Transform{};
-			if (Distributor->ExecuteDistribution(this, Transform, CameraLocation, ProceduralElement.Element))
+			if (UAmbiverseDistributor* Distributor{DistributorManager->GetDistributorByClass(DistributorClass)})
 			{
-				SoundSourceData.Transform = Transform;
+				Distributor->SetListenerState(Listener);
+			
+				FTransform Transform{};
+				if (Distributor->ExecuteDistribution(this, Transform, CameraLocation, ProceduralElement.Element))
+				{
+					SoundSourceData.Transform = Transform;
+				}
 			}
 		}
+		else
+		{
+			SoundSourceData.Transform = FAmbiverseSoundDistributionData::GetSoundTransform(
+				ProceduralElement.Element->DistributionData, CameraLocation, ProceduralElement.SpawnPointCursor);
+		}
 	}
-	else
+	
+	TRACE_AMBIVERSE_ELEMENT_FIRED(Layer, ProceduralElement, SoundSourceData.Sound, SoundSourceData.Transform.GetLocation(), DeferralLatency);
+	
+	/** Sounds that are out of range of every listener are culled. Distributors can place sounds anywhere, so this is checked after placement. */
+	if (SoundSourceData.Sound && !IsAudibleToAnyListener(ListenerStates, SoundSourceData.Transform.GetLocation(), SoundSourceData.Sound->GetMaxDistance()))
+	{
+		UE_LOG(LogAmbiverseSubsystem, VeryVerbose, TEXT("ProcessProceduralElement: Culled '%s', no listener in range."), *SoundSourceData.Name.ToString());
+		return;
+	}
+	
+	/** Distant elements can be rendered by a shared far field voice, which keeps the cost of dense layers constant. */
+	if (FarFieldManager && FarFieldManager->TryRenderFarField(SoundSourceData, Listener))
 	{
-		SoundSourceData.Transform = FAmbiverseSoundDistributionData::GetSoundTransform(
-			ProceduralElement.Element->DistributionData, CameraLocation);
+		return;
 	}
 	
 	if (!SoundSourceManager)
@@ -138,23 +463,64 @@ void UAmbiverseSubsystem::ProcessProceduralElement(UAmbiverseLayer* Layer, FAmbi
 	SoundSourceManager->InitiateSoundSource(SoundSourceData);
 }
 
-void UAmbiverseSubsystem::SetNewTimeForProceduralElement(FAmbiverseProceduralElement& ProceduralElement, UAmbiverseLayer* Layer)
+void UAmbiverseSubsystem::SetNewTimeForProceduralElement(UAmbiverseLayer* Layer, const int32 ElementIndex)
 {
-	ProceduralElement.ReferenceTime = FMath::RandRange(ProceduralElement.IntervalRange.X,
-													   ProceduralElement.IntervalRange.Y);
+	if (!Layer || !Layer->ProceduralElements.IsValidIndex(ElementIndex)) { return; }
 
-	float DensityModifier {1.0f};
-	float VolumeModifier {1.0f};
+	FAmbiverseProceduralElement& ProceduralElement {Layer->ProceduralElements[ElementIndex]};
+	ProceduralElement.ReferenceTime = RandomStream.FRandRange(ProceduralElement.IntervalRange.X, ProceduralElement.IntervalRange.Y);
+	ProceduralElement.Time = ProceduralElement.ReferenceTime * GetDensityModifier(Layer, ElementIndex);
+}
 
-	if (!ParameterManager)
+void UAmbiverseSubsystem::WarmUpProceduralElement(UAmbiverseLayer* Layer, const int32 ElementIndex)
+{
+	if (!Layer || !Layer->ProceduralElements.IsValidIndex(ElementIndex)) { return; }
+
+	FAmbiverseProceduralElement& ProceduralElement {Layer->ProceduralElements[ElementIndex]};
+	
+	/** An element that has been firing for a long time is usually part way through an interval, and is more likely to be in a long interval.
+	 *	For intervals drawn uniformly from [Min, Max] with mean Mean, the remaining time is uniform below Min with a total probability of Min / Mean,
+	 *	and above Min its density falls linearly to zero at Max. */
+	const float Min {FMath::Max(0.0f, static_cast<float>(ProceduralElement.IntervalRange.X))};
+	const float Max {FMath::Max(Min, static_cast<float>(ProceduralElement.IntervalRange.Y))};
+	const float Mean {(Min + Max) * 0.5f};
+
+	if (Mean <= UE_KINDA_SMALL_NUMBER)
 	{
-		UE_LOG(LogAmbiverseSubsystem, Error, TEXT("SetNewTimeForProceduralElement: ParameterManager is nullptr."));
+		ProceduralElement.ReferenceTime = 0.0f;
+		ProceduralElement.Time = 0.0f;
 		return;
 	}
+
+	if (RandomStream.FRand() * Mean < Min)
+	{
+		ProceduralElement.ReferenceTime = RandomStream.FRand() * Min;
+	}
+	else
+	{
+		ProceduralElement.ReferenceTime = Max - (Max - Min) * FMath::Sqrt(RandomStream.FRand());
+	}
 	
-	ParameterManager->GetScalarsForElement(DensityModifier, VolumeModifier, Layer, ProceduralElement);
+	ProceduralElement.Time = ProceduralElement.ReferenceTime * GetDensityModifier(Layer, ElementIndex);
+}
 
-	ProceduralElement.Time = ProceduralElement.ReferenceTime * DensityModifier;
+float UAmbiverseSubsystem::GetDensityModifier(const UAmbiverseLayer* Layer, const int32 ElementIndex) const
+{
+	if (!ParameterManager)
+	{
+		UE_LOG(LogAmbiverseSubsystem, Error, TEXT("GetDensityModifier: ParameterManager is nullptr."));
+		return 1.0f;
+	}
+	
+	float DensityModifier {1.0f};
+	float VolumeModifier {1.0f};
+	
+	ParameterManager->GetScalarsForElement(DensityModifier, VolumeModifier, Layer, ElementIndex);
+	
+	/** A layer that has faded out completely is scheduled so far ahead that it does not fire again before it expires. */
+	const float LifetimeDensityScalar {Layer ? FMath::Max(Layer->GetLifetimeDensityScalar(), UE_KINDA_SMALL_NUMBER) : 1.0f};
+	
+	return DensityModifier / (GetListenerDensityScalar(Layer) * LifetimeDensityScalar);
 }
 
 float UAmbiverseSubsystem::GetSoundVolume(const UAmbiverseLayer* Layer, const FAmbiverseProceduralElement& ProceduralElement)
@@ -165,29 +531,19 @@ float UAmbiverseSubsystem::GetSoundVolume(const UAmbiverseLayer* Layer, const FA
 	return Volume;
 }
 
-void UAmbiverseSubsystem::HandleParameterChanged()
+void UAmbiverseSubsystem::Deinitialize()
 {
-	if (!LayerManager || LayerManager->GetLayerRegistry().IsEmpty()) { return; }
-
-	UE_LOG(LogTemp, Warning, TEXT("Parameter Changed!"))
-
-	TArray<UAmbiverseLayer*> Layers {LayerManager->GetLayerRegistry()};
-	for (UAmbiverseLayer* Layer : Layers)
+	/** The bed and far field managers are bound to the layer manager, so they are deinitialized first. */
+	if (BedManager)
 	{
-		for (FAmbiverseProceduralElement Entry : Layer->ProceduralElements)
-		{
-			float DensityScalar {1.0f};
-			float VolumeScalar {1.0f};
-			
-			ParameterManager->GetScalarsForElement(DensityScalar, VolumeScalar, Layer, Entry);
-
-			Entry.Time = Entry.ReferenceTime * DensityScalar;
-		}
+		BedManager->Deinitialize(this);
+		BedManager = nullptr;
+	}
+	if (FarFieldManager)
+	{
+		FarFieldManager->Deinitialize(this);
+		FarFieldManager = nullptr;
 	}
-}
-
-void UAmbiverseSubsystem::Deinitialize()
-{
 	if (LayerManager)
 	{
 		LayerManager->Deinitialize(this);
@@ -196,7 +552,7 @@ void UAmbiverseSubsystem::Deinitialize()
 	if (ParameterManager)
 	{
 		ParameterManager->Deinitialize(this);
-		SoundSourceManager = nullptr;
+		ParameterManager = nullptr;
 	}
 	if (SoundSourceManager)
 	{
@@ -0,0 +1,112 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseTrace.h"
+
+#if AMBIVERSE_TRACE_ENABLED
+
+#include "AmbiverseElement.h"
+#include "AmbiverseLayer.h"
+#include "AmbiverseParameter.h"
+#include "AmbiverseProceduralElement.h"
+#include "AmbiverseSoundSourceData.h"
+
+UE_TRACE_CHANNEL_DEFINE(AmbiverseChannel)
+
+UE_TRACE_EVENT_BEGIN(Ambiverse, Name, NoSync|Important)
+	UE_TRACE_EVENT_FIELD(uint64, Id)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Name)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Ambiverse, ElementFired)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, LayerId)
+	UE_TRACE_EVENT_FIELD(uint64, ElementId)
+	UE_TRACE_EVENT_FIELD(uint64, SoundId)
+	UE_TRACE_EVENT_FIELD(float, X)
+	UE_TRACE_EVENT_FIELD(float, Y)
+	UE_TRACE_EVENT_FIELD(float, Z)
+	UE_TRACE_EVENT_FIELD(float, DeferralLatency)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Ambiverse, VoiceRequest)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, ElementId)
+	UE_TRACE_EVENT_FIELD(uint8, Result)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Ambiverse, ParameterChanged)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, ParameterId)
+	UE_TRACE_EVENT_FIELD(float, Value)
+UE_TRACE_EVENT_END()
+
+TSet<uint64> FAmbiverseTrace::OutputNameIds;
+
+void FAmbiverseTrace::OutputElementFired(const UAmbiverseLayer* Layer, const FAmbiverseProceduralElement& ProceduralElement, const USoundBase* Sound,
+	const FVector& Location, const float DeferralLatency)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(AmbiverseChannel)) { return; }
+
+	const uint64 LayerId {OutputName(Layer ? Layer->GetFName() : NAME_None)};
+	const uint64 ElementId {OutputName(ProceduralElement.Element ? ProceduralElement.Element->GetFName() : NAME_None)};
+	const uint64 SoundId {OutputName(Sound ? Sound->GetFName() : NAME_None)};
+
+	UE_TRACE_LOG(Ambiverse, ElementFired, AmbiverseChannel)
+		<< ElementFired.Cycle(FPlatformTime::Cycles64())
+		<< ElementFired.LayerId(LayerId)
+		<< ElementFired.ElementId(ElementId)
+		<< ElementFired.SoundId(SoundId)
+		<< ElementFired.X(static_cast<float>(Location.X))
+		<< ElementFired.Y(static_cast<float>(Location.Y))
+		<< ElementFired.Z(static_cast<float>(Location.Z))
+		<< ElementFired.DeferralLatency(DeferralLatency);
+}
+
+void FAmbiverseTrace::OutputVoiceRequest(const FAmbiverseSoundSourceData& SoundSourceData, const EAmbiverseTraceVoiceResult Result)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(AmbiverseChannel)) { return; }
+
+	const uint64 ElementId {OutputName(SoundSourceData.Name)};
+
+	UE_TRACE_LOG(Ambiverse, VoiceRequest, AmbiverseChannel)
+		<< VoiceRequest.Cycle(FPlatformTime::Cycles64())
+		<< VoiceRequest.ElementId(ElementId)
+		<< VoiceRequest.Result(static_cast<uint8>(Result));
+}
+
+void FAmbiverseTrace::OutputParameterChanged(const UAmbiverseParameter* Parameter, const float Value)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(AmbiverseChannel)) { return; }
+
+	const uint64 ParameterId {OutputName(Parameter ? Parameter->GetFName() : NAME_None)};
+
+	UE_TRACE_LOG(Ambiverse, ParameterChanged, AmbiverseChannel)
+		<< ParameterChanged.Cycle(FPlatformTime::Cycles64())
+		<< ParameterChanged.ParameterId(ParameterId)
+		<< ParameterChanged.Value(Value);
+}
+
+uint64 FAmbiverseTrace::OutputName(const FName ObjectName)
+{
+	const uint64 Id {static_cast<uint64>(ObjectName.GetComparisonIndex().ToUnstableInt()) << 32 | static_cast<uint64>(ObjectName.GetNumber())};
+
+	/** Every name only has to be sent once per trace session. */
+	bool IsAlreadyOutput {false};
+	OutputNameIds.Add(Id, &IsAlreadyOutput);
+	if (IsAlreadyOutput) { return Id; }
+
+	const FString NameString {ObjectName.ToString()};
+	
+	UE_TRACE_LOG(Ambiverse, Name, AmbiverseChannel)
+		<< Name.Id(Id)
+		<< Name.Name(*NameString, NameString.Len());
+
+	return Id;
+}
+
+void FAmbiverseTrace::ResetOutputNames()
+{
+	OutputNameIds.Reset();
+}
+
+#endif
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "AmbiverseParameterMailbox.h"
 #include "AmbiverseBPLibrary.generated.h"
 
 UCLASS()
@@ -12,13 +13,30 @@ class UAmbiverseBPLibrary : public UBlueprintFunctionLibrary
 
 	UFUNCTION(BlueprintCallable, Category = "Ambiverse", Meta = (DisplayName = "Add Ambiverse Layer", Keywords = "Ambiverse Add Layer",
 		WorldContext = "WorldContextObject", DefaultToSelf = "WorldContextObject"))
-	static void AddAmbiverseLayer(UObject* WorldContextObject, UAmbiverseLayer* AmbiverseLayer);
+	static void AddAmbiverseLayer(UObject* WorldContextObject, UAmbiverseLayer* AmbiverseLayer, const int32 OwningListenerIndex = -1);
 
 	UFUNCTION(BlueprintCallable, Category = "Ambiverse", Meta = (DisplayName = "Pop Ambiverse Layer", Keywords = "Ambiverse Pop Layer",
 		WorldContext = "WorldContextObject", DefaultToSelf = "WorldContextObject"))
 	static void PopAmbiverseLayer(UObject* WorldContextObject, UAmbiverseLayer* AmbiverseLayer);
 
+	UFUNCTION(BlueprintCallable, Category = "Ambiverse", Meta = (DisplayName = "Push Ambiverse Composite", Keywords = "Ambiverse Push Composite",
+		WorldContext = "WorldContextObject", DefaultToSelf = "WorldContextObject"))
+	static void PushAmbiverseComposite(UObject* WorldContextObject, UAmbiverseComposite* AmbiverseComposite);
+
+	UFUNCTION(BlueprintCallable, Category = "Ambiverse", Meta = (DisplayName = "Pop Ambiverse Composite", Keywords = "Ambiverse Pop Composite",
+		WorldContext = "WorldContextObject", DefaultToSelf = "WorldContextObject"))
+	static void PopAmbiverseComposite(UObject* WorldContextObject);
+
 	UFUNCTION(BlueprintCallable, Category = "Ambiverse", Meta = (DisplayName = "Set Ambiverse Parameter", Keywords = "Ambiverse Set Parameter",
 		WorldContext = "WorldContextObject", DefaultToSelf = "WorldContextObject"))
 	static void SetAmbiverseParameter(UObject* WorldContextObject, UAmbiverseParameter* AmbiverseParameter, const float Value);
+
+	UFUNCTION(BlueprintCallable, Category = "Ambiverse", Meta = (DisplayName = "Get Ambiverse Parameter Handle", Keywords = "Ambiverse Get Parameter Handle",
+		WorldContext = "WorldContextObject", DefaultToSelf = "WorldContextObject"))
+	static FAmbiverseParameterHandle GetAmbiverseParameterHandle(UObject* WorldContextObject, UAmbiverseParameter* AmbiverseParameter);
+
+	/** Sets the values of multiple parameters at once. Each handle is paired with the value at the same index. */
+	UFUNCTION(BlueprintCallable, Category = "Ambiverse", Meta = (DisplayName = "Set Ambiverse Parameters", Keywords = "Ambiverse Set Parameters Batch",
+		WorldContext = "WorldContextObject", DefaultToSelf = "WorldContextObject"))
+	static void SetAmbiverseParameters(UObject* WorldContextObject, const TArray<FAmbiverseParameterHandle>& Handles, const TArray<float>& Values);
 };
@@ -0,0 +1,88 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AmbiverseSubsystemComponent.h"
+#include "AmbiverseBedManager.generated.h"
+
+class UAmbiverseLayer;
+class UAmbiverseParameter;
+class UAudioComponent;
+class UMetaSoundSource;
+
+/** A bed element of an active layer, and the voices that play it. */
+USTRUCT()
+struct FAmbiverseBed
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	UAmbiverseLayer* Layer {nullptr};
+
+	/** The index of the element in the procedural elements of the layer. */
+	int32 ElementIndex {INDEX_NONE};
+
+	/** A bed uses one voice, and a second one while it crossfades to another sound. */
+	UPROPERTY()
+	UAudioComponent* Voices[2] {nullptr, nullptr};
+
+	/** The index of the voice that is currently audible. The other voice is silent or fading out. */
+	int32 ActiveVoice {0};
+
+	/** The time until the bed crossfades to another sound, either at the crossfade interval of its element,
+	 *	or ahead of the end of a sound that does not loop by itself. */
+	float TimeUntilCrossfade {0.0f};
+
+	/** The duration of the next crossfade. Shorter than the crossfade duration of the element if the active sound is too short to overlap by that much. */
+	float CrossfadeDuration {0.0f};
+
+	/** The volume that was last applied to the voices. */
+	float Volume {0.0f};
+};
+
+/** Plays the bed elements of the active layers as persistent, non-spatialized looping voices.
+ *	Instead of being fired, each bed keeps a single voice playing for as long as its layer is active, and periodically crossfades to another sound.
+ *	The volume of a bed follows the volume modifiers of its parameters, the lifetime of its layer and the transition fade of its layer. */
+UCLASS()
+class AMBIVERSE_API UAmbiverseBedManager : public UAmbiverseSubsystemComponent
+{
+	GENERATED_BODY()
+
+	DECLARE_LOG_CATEGORY_CLASS(LogAmbiverseBedManager, Log, All)
+
+private:
+	UPROPERTY(Transient)
+	TArray<FAmbiverseBed> Beds;
+
+public:
+	virtual void Initialize(UAmbiverseSubsystem* Subsystem) override;
+	virtual void Deinitialize(UAmbiverseSubsystem* Subsystem) override;
+	
+	virtual void Tick(const float DeltaTime) override;
+
+private:
+	UFUNCTION()
+	void HandleOnLayerRegistered(UAmbiverseLayer* RegisteredLayer);
+
+	UFUNCTION()
+	void HandleOnLayerUnregistered(UAmbiverseLayer* UnregisteredLayer);
+
+	/** Starts a new sound on the inactive voice of a bed and crossfades to it. The previous voice fades out over the same duration. */
+	void CrossfadeBed(FAmbiverseBed& Bed, const float FadeDuration);
+
+	/** Returns the volume of a bed, based on its element, its parameters and the fades of its layer. */
+	float GetBedVolume(const FAmbiverseBed& Bed) const;
+
+	/** Sends the forwarded parameters of the element of a bed to its voices. If changed parameters are provided, only those are sent. */
+	static void ForwardParameters(const FAmbiverseBed& Bed, const TArray<UAmbiverseParameter*>* ChangedParameters = nullptr);
+
+	/** Fades out and releases the voices of a bed. */
+	static void StopBed(FAmbiverseBed& Bed, const float FadeOutDuration);
+
+public:
+	/** Returns the number of voices that are currently used by beds. */
+	int32 GetBedVoiceCount() const;
+
+	FORCEINLINE int32 GetBedCount() const { return Beds.Num(); }
+};
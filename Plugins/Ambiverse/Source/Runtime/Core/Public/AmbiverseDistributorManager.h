@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "AmbiverseFloorCache.h"
 #include "AmbiverseSubsystemComponent.h"
 #include "AmbiverseDistributorManager.generated.h"
 
@@ -21,9 +22,24 @@ private:
 	UPROPERTY()
 	TArray<UAmbiverseDistributor*> Distributors;
 
+	/** Floor heights around the listener, shared by all distributors. */
+	FAmbiverseFloorCache FloorCache;
+
 public:
+	virtual void Initialize(UAmbiverseSubsystem* Subsystem) override;
+
+	virtual void Deinitialize(UAmbiverseSubsystem* Subsystem) override;
+
+	virtual void Tick(const float DeltaTime) override;
+	
 	/** Searches for a distributor instance in the registry. Will instance one if no instance was found. */
 	UAmbiverseDistributor* GetDistributorByClass(TSubclassOf<UAmbiverseDistributor> Class);
 	
+private:
+	UFUNCTION()
+	void HandleOnListenerViewTargetChanged(AActor* ViewTarget);
+
+public:
 	FORCEINLINE TArray<UAmbiverseDistributor*> GetDistributorRegistry() const { return Distributors; }
+	FORCEINLINE const FAmbiverseFloorCache& GetFloorCache() const { return FloorCache; }
 };
@@ -0,0 +1,95 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AmbiverseSubsystemComponent.h"
+#include "AmbiverseFarFieldManager.generated.h"
+
+class UAmbiverseLayer;
+class UAudioComponent;
+class UMetaSoundSource;
+struct FAmbiverseListenerState;
+struct FAmbiverseSoundSourceData;
+
+/** A shared, non-spatialized voice that renders the distant instances of elements through a panning MetaSound. */
+USTRUCT()
+struct FAmbiverseFarFieldVoice
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The MetaSound the voice plays. Voices are shared between all elements of a layer that use the same far field source. */
+	UPROPERTY()
+	UMetaSoundSource* Source {nullptr};
+
+	/** The layer whose instances the voice plays. Voices are not shared between layers, so they fade and are released along with their layer. */
+	UPROPERTY()
+	UAmbiverseLayer* Layer {nullptr};
+
+	UPROPERTY()
+	UAudioComponent* AudioComponent {nullptr};
+
+	/** The layer volume that was last applied to the voice. */
+	float Gain {1.0f};
+
+	/** The world time at which the voice was last triggered. Idle voices are stopped. */
+	double LastTriggerTime {0.0};
+};
+
+/** Renders distant procedural elements through a small, fixed set of shared voices instead of spawning a spatialized sound source for each of them.
+ *	Far field sources are MetaSounds that play a wave every time their trigger input is set, and pan it with a quad panner.
+ *	They are expected to expose the following inputs:
+ *	- Play (Trigger): Plays a new instance.
+ *	- Wave (Wave Asset): The wave of the instance, from the far field waves of the element.
+ *	- Azimuth (Float): The direction of the instance relative to the listener in degrees. 0 is in front, 90 is to the right.
+ *	- Distance (Float): The distance of the instance to the listener in centimeters.
+ *	- Gain (Float): The volume of the instance. The lifetime and transition fades of the layer are applied to the voice as a whole instead.
+ *	The inputs of an instance are sent in the same tick as its trigger, so they arrive in the same audio block. A voice is shared by many instances,
+ *	so the MetaSound should latch the inputs when Play is triggered, for example by feeding them into a polyphonic wave player and panner.
+ *	A MetaSound that reads the inputs continuously moves the instances that are still sounding to the position of the most recent one. */
+UCLASS()
+class AMBIVERSE_API UAmbiverseFarFieldManager : public UAmbiverseSubsystemComponent
+{
+	GENERATED_BODY()
+
+	DECLARE_LOG_CATEGORY_CLASS(LogAmbiverseFarField, Log, All)
+
+private:
+	UPROPERTY(Transient)
+	TArray<FAmbiverseFarFieldVoice> Voices;
+
+	/** The index of the voice that was last triggered for each source and layer, so instances are distributed over the voices of a source.
+	 *	Entries are removed when the last voice of their source and layer is released, so the keys always point at objects referenced by the voices. */
+	TMap<TPair<const UMetaSoundSource*, const UAmbiverseLayer*>, int32> VoiceCursors;
+
+public:
+	virtual void Initialize(UAmbiverseSubsystem* Subsystem) override;
+	virtual void Deinitialize(UAmbiverseSubsystem* Subsystem) override;
+	
+	virtual void Tick(const float DeltaTime) override;
+
+	/** Plays a sound through a shared far field voice if its element has a far field source and it is far enough from the listener.
+	 * @return False if the sound should be played by a regular sound source instead. */
+	bool TryRenderFarField(const FAmbiverseSoundSourceData& SoundSourceData, const FAmbiverseListenerState& Listener);
+
+#if WITH_EDITOR
+	/** Returns an error for every input a far field source is expected to expose, but is missing or has a different type. */
+	static TArray<FText> ValidateFarFieldSource(const UMetaSoundSource* Source);
+#endif
+
+private:
+	/** Returns a voice for a far field source and layer, creating one if the voice limits allow it. */
+	FAmbiverseFarFieldVoice* AcquireVoice(UMetaSoundSource* Source, UAmbiverseLayer* Layer);
+
+	/** Fades out a voice and removes it. The audio component is destroyed once the fade has finished. */
+	void ReleaseVoice(const int32 Index, const float FadeOutDuration);
+
+	/** Returns the volume of the voices of a layer, based on the fades of the layer. */
+	static float GetLayerGain(const UAmbiverseLayer* Layer);
+
+	UFUNCTION()
+	void HandleOnLayerUnregistered(UAmbiverseLayer* UnregisteredLayer);
+
+public:
+	FORCEINLINE int32 GetFarFieldVoiceCount() const { return Voices.Num(); }
+};
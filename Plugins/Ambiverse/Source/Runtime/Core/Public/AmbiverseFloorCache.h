@@ -0,0 +1,69 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WorldCollision.h"
+
+/** A small rolling heightfield of floor heights centered on the listener.
+ *	Cells are filled by bounded asynchronous downward traces, so floor heights near the listener can be looked up without a scene query.
+ *	The grid is indexed toroidally: when the listener moves, only the cells that scroll into view need to be traced again. */
+class AMBIVERSE_API FAmbiverseFloorCache
+{
+	/** A single height sample at a grid vertex. */
+	struct FCell
+	{
+		FIntPoint GridCoordinates {MAX_int32, MAX_int32};
+		float Height {0.0f};
+		bool HasFloor {false};
+		bool IsValid {false};
+		bool IsPending {false};
+	};
+
+	TArray<FCell> Cells;
+
+	/** Offsets from the center of the grid, sorted by distance. Cells close to the listener are traced first. */
+	TArray<FIntPoint> FillOrder;
+
+	int32 Resolution {0};
+	float CellSize {0.0f};
+	float TraceHalfHeight {0.0f};
+
+	/** The grid coordinates of the vertex with the lowest coordinates that is covered by the cache. */
+	FIntPoint Origin {0, 0};
+
+	/** The listener height the current cells were traced at. */
+	float ReferenceHeight {0.0f};
+
+	FTraceDelegate TraceDelegate;
+
+public:
+	/** Allocates the grid and binds the trace delegate. Trace results are ignored once the owner is destroyed. */
+	void Initialize(UObject* Owner, const int32 InResolution, const float InCellSize, const float InTraceHalfHeight);
+
+	/** Recenters the cache on the listener and issues traces for cells that have no valid height yet.
+	 * @return The number of traces issued. */
+	int32 Update(UWorld* World, const FVector& ListenerLocation, const AActor* IgnoredActor, const int32 MaxTraceCount);
+
+	/** Samples the floor height at a location using bilinear interpolation between the four surrounding cells.
+	 * @return False if any of the surrounding cells is not available. */
+	bool SampleHeight(const FVector2D& Location, float& OutHeight) const;
+
+	/** Invalidates all cells. */
+	void Invalidate();
+
+	FORCEINLINE float GetTraceHalfHeight() const { return TraceHalfHeight; }
+	FORCEINLINE bool IsInitialized() const { return Resolution > 0; }
+
+private:
+	void HandleTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	const FCell* FindCell(const FIntPoint& GridCoordinates) const;
+
+	FORCEINLINE int32 GetCellIndex(const FIntPoint& GridCoordinates) const
+	{
+		const int32 X {((GridCoordinates.X % Resolution) + Resolution) % Resolution};
+		const int32 Y {((GridCoordinates.Y % Resolution) + Resolution) % Resolution};
+		return X + Y * Resolution;
+	}
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "AmbiverseLayer.h"
+#include "AmbiverseListenerState.h"
 #include "AmbiverseSubsystemComponent.h"
 #include "AmbiverseLayerManager.generated.h"
 
@@ -12,7 +13,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLayerRegisteredDelegate, UAmbiver
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLayerUnregisteredDelegate, UAmbiverseLayer*, UnregisteredLayer);
 
 UCLASS()
-class UAmbiverseLayerManager : public UAmbiverseSubsystemComponent
+class AMBIVERSE_API UAmbiverseLayerManager : public UAmbiverseSubsystemComponent
 {
 	GENERATED_BODY()
 
@@ -26,36 +27,101 @@ public:
 	FOnLayerRegisteredDelegate OnLayerUnregistered;
 
 private:
+	/** A layer with a lifetime, and the time at which it expires. */
+	struct FLayerExpiry
+	{
+		double ExpiryTime {0.0};
+		TWeakObjectPtr<UAmbiverseLayer> Layer;
+
+		FORCEINLINE bool operator<(const FLayerExpiry& Other) const { return ExpiryTime < Other.ExpiryTime; }
+	};
+	
 	/** The current active ambience layers. */
 	UPROPERTY()
 	TArray<UAmbiverseLayer*> ActiveLayers;
 
-public:
-	virtual void Initialize(UAmbiverseSubsystem* Subsystem) override;
-	virtual void Deinitialize(UAmbiverseSubsystem* Subsystem) override;
+	/** The same layers as ActiveLayers, for constant time lookups. */
+	TSet<UAmbiverseLayer*> ActiveLayerSet;
+
+	/** Composites that have been pushed, with the most recent composite last. */
+	UPROPERTY()
+	TArray<UAmbiverseComposite*> CompositeStack;
+
+	/** Layers that are crossfading, with the change of their transition fade per second. Layers that fade out are unregistered once silent. */
+	TMap<UAmbiverseLayer*, float> FadingLayers;
+
+	/** The listener that owns each layer that was registered with an owning listener index. Other layers are shared between all listeners.
+	 *	This is state of the registration, so it is kept here instead of on the layer asset. */
+	TMap<const UAmbiverseLayer*, int32> OwningListenerIndices;
+
+	/** A min-heap of the active layers that have a lifetime, ordered by the time at which they expire. */
+	TArray<FLayerExpiry> ExpiryQueue;
+
+	/** The time in seconds the layer manager has been ticked for. Expiry times are expressed in this time. */
+	double ElapsedTime {0.0};
 
+public:
 	virtual void Tick(const float DeltaTime) override;
 	
-	void RegisterAmbiverseLayer(UAmbiverseLayer* Layer);
+	/** Registers a layer. If an owning listener index is provided, the layer is only placed around that listener. */
+	void RegisterAmbiverseLayer(UAmbiverseLayer* Layer, const int32 OwningListenerIndex = INDEX_NONE);
 	void UnregisterAmbiverseLayer(UAmbiverseLayer* Layer);
 
-	void InitializeLayer(UAmbiverseLayer* Layer, const uint16 WarmUpCount = 3);
+	/** Prepares a layer for registration. If warm up is enabled, the elements start as if the layer had already been active for a long time,
+	 *	otherwise every element waits a full interval before it fires. */
+	void InitializeLayer(UAmbiverseLayer* Layer, const bool WarmUp = true);
 
 	void RegisterAmbiverseComposite(UAmbiverseComposite* Composite);
 	void UnregisterAmbiverseComposite(UAmbiverseComposite* Composite);
+
+	/** Pushes a composite onto the composite stack and crossfades to its layers. */
+	void PushComposite(UAmbiverseComposite* Composite);
+
+	/** Pops the most recently pushed composite and crossfades back to the layers of the composites below it. */
+	void PopComposite();
+
+	/** Crossfades from the active layers to a set of target layers. Layers that are active in both are left untouched.
+	 *	The difference is computed before any layer is changed, so a transition is applied as a whole. */
+	void TransitionToLayers(const TArray<UAmbiverseLayer*>& TargetLayers, const float CrossfadeDuration);
 	
 	/** Checks if an ambience layer is already active*/
 	UAmbiverseLayer* FindActiveAmbienceLayer(const UAmbiverseLayer* LayerToFind) const;
 
+	/** Advances the procedural elements of a layer and fires the elements that are due. Public so the benchmarks can time it in isolation. */
+	void UpdateElements(float DeltaTime, UAmbiverseLayer* Layer, const TArray<FAmbiverseListenerState>& Listeners);
+
 private:
-	UFUNCTION()
-	void HandleOnParameterChanged(UAmbiverseParameter* ChangedParameter);
+	/** Rescales the remaining time of every active element that depends on a changed parameter. */
+	void ApplyParameterChanges(const TArray<UAmbiverseParameter*>& ChangedParameters);
+
+	void UpdateActiveLayers(float DeltaTime, const TArray<FAmbiverseListenerState>& Listeners);
+
+	/** Unregisters all layers whose lifetime has passed, and fades out their sounds. */
+	void ExpireLayers();
+
+	/** Advances the transition fades of crossfading layers, and unregisters layers that have faded out. */
+	void UpdateFadingLayers(const float DeltaTime);
 
-	void UpdateActiveLayers(float DeltaTime);
+	/** Returns the active layers that are not fading out. Transitions start from these layers, so a layer that is fading out is not faded back in
+	 *	unless it is part of the new target layers. */
+	TArray<UAmbiverseLayer*> GetRemainingLayers() const;
 
-	void UpdateElements(float DeltaTime, UAmbiverseLayer* Layer);
+	/** Returns the layers of the composite stack. A composite that stops non-composite layers hides the composites below it. */
+	TArray<UAmbiverseLayer*> GetCompositeStackLayers() const;
 
 public:
 	FORCEINLINE TArray<UAmbiverseLayer*> GetLayerRegistry() const { return ActiveLayers; }
+	FORCEINLINE int32 GetActiveLayerCount() const { return ActiveLayers.Num(); }
+	FORCEINLINE const TArray<UAmbiverseComposite*>& GetCompositeStack() const { return CompositeStack; }
+
+	/** Returns the index of the listener that owns an active layer, or INDEX_NONE if the layer is shared between all listeners. */
+	FORCEINLINE int32 GetOwningListenerIndex(const UAmbiverseLayer* Layer) const
+	{
+		const int32* OwningListenerIndex {OwningListenerIndices.Find(Layer)};
+		return OwningListenerIndex ? *OwningListenerIndex : INDEX_NONE;
+	}
+
+	/** Returns the number of procedural elements that are waiting to fire across all active layers. */
+	int32 GetScheduledEventCount() const;
 	
 };
@@ -0,0 +1,105 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/CurveTable.h"
+#include "UObject/FieldPath.h"
+#include "AmbiverseParameterMailbox.h"
+#include "AmbiverseParameterBindingComponent.generated.h"
+
+class UAmbiverseParameter;
+class UAmbiverseParameterManager;
+
+/** The source a parameter binding samples its value from. */
+UENUM(BlueprintType)
+enum class EAmbiverseBindingSource : uint8
+{
+	Speed			UMETA(DisplayName = "Speed", ToolTip = "The speed of the movement component, or of the actor if no movement component is found, in units per second."),
+	FloatProperty	UMETA(DisplayName = "Float Property", ToolTip = "A numeric property on the actor or on one of its components."),
+	Function		UMETA(DisplayName = "Function", ToolTip = "A function without parameters that returns a number, for example the engine rotation speed of a vehicle movement component."),
+	CurveTable		UMETA(DisplayName = "Curve Table", ToolTip = "A curve table row, evaluated at the time in seconds since the world began playing.")
+};
+
+/** Maps a parameter to a value on the owning actor. Bindings are sampled centrally by the ParameterManager. */
+USTRUCT(BlueprintType)
+struct AMBIVERSE_API FAmbiverseParameterBinding
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Binding")
+	UAmbiverseParameter* Parameter {nullptr};
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Binding")
+	EAmbiverseBindingSource Source {EAmbiverseBindingSource::Speed};
+
+	/** The component to sample from. If not set, the actor itself is used, or its movement component for speed. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Binding", Meta = (EditCondition = "Source != EAmbiverseBindingSource::CurveTable", EditConditionHides))
+	TSubclassOf<UActorComponent> ComponentClass;
+
+	/** The name of the property or function to sample. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Binding",
+		Meta = (EditCondition = "Source == EAmbiverseBindingSource::FloatProperty || Source == EAmbiverseBindingSource::Function", EditConditionHides))
+	FName MemberName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Binding", Meta = (EditCondition = "Source == EAmbiverseBindingSource::CurveTable", EditConditionHides))
+	FCurveTableRowHandle CurveRow;
+
+	/** Multiplies the sampled value before it is applied, for example to convert a speed in centimeters per second to kilometers per hour. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Binding")
+	float Scale {1.0f};
+
+	/** The number of times per second the binding is sampled. Zero samples the binding every tick. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Binding", Meta = (ClampMin = "0", UIMin = "0", UIMax = "60", Units = "Hertz"))
+	float SampleRate {10.0f};
+
+	/** The minimum change in the scaled value before it is applied to the parameter. Smaller changes produce no work.
+	 *	Zero applies every change. The threshold is in the units of the scaled value, so it should be small for parameters with a small range. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Binding", Meta = (ClampMin = "0", UIMin = "0"))
+	float ChangeThreshold {0.0f};
+
+	FAmbiverseParameterHandle Handle;
+	
+	float TimeUntilSample {0.0f};
+	float LastValue {0.0f};
+	bool HasValue {false};
+
+	/** The object and member the binding samples from, resolved on the first sample. */
+	TWeakObjectPtr<UObject> Target;
+	TWeakObjectPtr<UFunction> Function;
+	TFieldPath<FNumericProperty> Property;
+	bool IsResolved {false};
+};
+
+/** Drives Ambiverse parameters from values on the owning actor, without the need for the actor to tick.
+ *	The component registers itself with the ParameterManager, which samples all bindings once per tick at their own rate. */
+UCLASS(ClassGroup = "Ambiverse", Meta = (BlueprintSpawnableComponent, DisplayName = "Ambiverse Parameter Binding"))
+class AMBIVERSE_API UAmbiverseParameterBindingComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+	DECLARE_LOG_CATEGORY_CLASS(LogAmbiverseParameterBinding, Log, All)
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Bindings")
+	TArray<FAmbiverseParameterBinding> Bindings;
+
+public:
+	UAmbiverseParameterBindingComponent();
+
+	/** Samples every binding whose interval has elapsed, and applies the values that changed more than their threshold. */
+	void UpdateBindings(const float DeltaTime, UAmbiverseParameterManager* ParameterManager);
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	/** Finds the object and member a binding samples from. */
+	void ResolveBinding(FAmbiverseParameterBinding& Binding) const;
+
+	bool SampleBinding(FAmbiverseParameterBinding& Binding, float& OutValue) const;
+
+	UAmbiverseParameterManager* GetParameterManager() const;
+};
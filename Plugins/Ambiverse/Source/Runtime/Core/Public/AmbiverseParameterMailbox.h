@@ -0,0 +1,56 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/TripleBuffer.h"
+#include "AmbiverseParameterMailbox.generated.h"
+
+/** A precomputed reference to a registered parameter. Handles are obtained from the ParameterManager on the game thread,
+ *	and can then be used to set values without looking up the parameter, from any thread through the parameter mailbox. */
+USTRUCT(BlueprintType)
+struct AMBIVERSE_API FAmbiverseParameterHandle
+{
+	GENERATED_BODY()
+
+	/** The index of the parameter in the registry of the ParameterManager. */
+	UPROPERTY()
+	int32 Index {INDEX_NONE};
+
+	FORCEINLINE bool IsValid() const { return Index != INDEX_NONE; }
+};
+
+/** Passes parameter values from a single producer thread, for example the physics thread, to the game thread without locking.
+ *	The producer publishes a snapshot of the latest value of every parameter it has set through a triple buffer.
+ *	The ParameterManager consumes the most recent snapshot at the start of its tick, and only applies the values that changed.
+ *	Intermediate snapshots that are published between two ticks are skipped, since each snapshot contains all values. */
+class AMBIVERSE_API FAmbiverseParameterMailbox
+{
+	DECLARE_LOG_CATEGORY_CLASS(LogAmbiverseParameterMailbox, Log, All)
+
+	struct FSnapshot
+	{
+		TArray<float> Values;
+		
+		/** Marks the parameters the producer has set a value for. */
+		TBitArray<> IsSet;
+	};
+
+	TTripleBuffer<FSnapshot> Buffer;
+
+	/** The latest values set by the producer. Only accessed by the producer. */
+	FSnapshot ProducerSnapshot;
+
+	/** The values that were last applied. Only accessed by the consumer. */
+	FSnapshot ConsumerSnapshot;
+
+public:
+	/** Sets the values of a batch of parameters and publishes them. May only be called from a single thread at a time. */
+	void SetParameters(TArrayView<const FAmbiverseParameterHandle> Handles, TArrayView<const float> Values);
+
+	void SetParameter(const FAmbiverseParameterHandle Handle, const float Value);
+
+	/** Calls the consumer for every parameter whose value changed since the last consumed snapshot. Must be called from the game thread.
+	 *	@return False if no new snapshot was published. */
+	bool Consume(TFunctionRef<void(const int32 Index, const float Value)> Consumer);
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "AmbiverseLayer.h"
+#include "AmbiverseParameterMailbox.h"
 #include "AmbiverseSubsystemComponent.h"
 #include "AmbiverseParameterManager.generated.h"
 
@@ -11,9 +12,10 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnParameterChangedDelegate, UAmbive
 
 class UAmbiverseLayer;
 class UAmbiverseParameter;
+class UAmbiverseParameterBindingComponent;
 
 UCLASS()
-class UAmbiverseParameterManager : public UAmbiverseSubsystemComponent
+class AMBIVERSE_API UAmbiverseParameterManager : public UAmbiverseSubsystemComponent
 {
 	GENERATED_BODY()
 
@@ -24,21 +26,66 @@ public:
 	FOnParameterChangedDelegate OnParameterChangedDelegate;
 
 private:
+	/** The smoothing state of a registered parameter. */
+	struct FParameterState
+	{
+		/** The normalized value the parameter is moving towards. */
+		float TargetValue {0.0f};
+		float Velocity {0.0f};
+	};
+	
 	/** The Ambiverse parameters that are currently registered to the system. */
 	UPROPERTY(Transient)
 	TArray<UAmbiverseParameter*> ParameterRegistry;
 
+	/** The smoothing state of each registered parameter, stored at the same index as the parameter in the registry. */
+	TArray<FParameterState> ParameterStates;
+
+	/** Maps a registered parameter to its index in the registry. */
+	TMap<const UAmbiverseParameter*, int32> ParameterIndices;
+
+	/** Marks parameters whose value has changed since the last tick, stored at the same index as the parameter in the registry. */
+	TBitArray<> DirtyParameters;
+
+	/** The parameters whose value changed during the last tick. */
+	TArray<UAmbiverseParameter*> ChangedParameters;
+
+	/** Receives parameter values from other threads. Consumed at the start of every tick. */
+	TSharedRef<FAmbiverseParameterMailbox, ESPMode::ThreadSafe> ParameterMailbox {MakeShared<FAmbiverseParameterMailbox, ESPMode::ThreadSafe>()};
+
+	/** The components whose bindings are sampled every tick. */
+	TArray<TWeakObjectPtr<UAmbiverseParameterBindingComponent>> BindingComponents;
+
 public:
 	virtual void Initialize(UAmbiverseSubsystem* Subsystem) override;
 	virtual void Deinitialize(UAmbiverseSubsystem* Subsystem) override;
+
+	/** Integrates the values of all smoothed parameters and notifies listeners of every parameter that changed since the last tick, once per parameter. */
+	virtual void Tick(const float DeltaTime) override;
 	
-	void GetScalarsForElement(float& DensityScalar, float& VolumeScalar, const UAmbiverseLayer* Layer, const FAmbiverseProceduralElement& ProceduralElement);
+	/** Returns the density and volume scalars of the procedural element at an index of a layer. */
+	void GetScalarsForElement(float& DensityScalar, float& VolumeScalar, const UAmbiverseLayer* Layer, const int32 ElementIndex);
 
+	/** Sets the target value of a parameter. Parameters without smoothing are applied immediately,
+	 *	but change notifications are always deferred to the next tick, so setting a value every frame is cheap. */
 	UFUNCTION(BlueprintCallable)
 	void SetParameterValue(UAmbiverseParameter* Parameter, const float Value);
 
+	/** Sets the values of a batch of parameters by handle. Must be called from the game thread, use the parameter mailbox from other threads. */
+	void SetParameters(TArrayView<const FAmbiverseParameterHandle> Handles, TArrayView<const float> Values);
+
+	/** Registers a parameter if needed, and returns a handle that can be used to set its value without looking it up. */
+	UFUNCTION(BlueprintCallable)
+	FAmbiverseParameterHandle GetParameterHandle(UAmbiverseParameter* Parameter);
+
+	void RegisterBindingComponent(UAmbiverseParameterBindingComponent* BindingComponent);
+	void UnregisterBindingComponent(UAmbiverseParameterBindingComponent* BindingComponent);
+
 private:
-	void RegisterParameter(UAmbiverseParameter* Parameter);
+	void SetParameterValueAtIndex(const int32 Index, const float Value);
+
+	/** Registers a parameter if it isn't registered yet, and returns its index in the registry. */
+	int32 RegisterParameter(UAmbiverseParameter* Parameter);
 	
 	bool IsParameterRegistered(const UAmbiverseParameter* Parameter) const;
 
@@ -48,4 +95,11 @@ private:
 public:
 	/** Returns an array of currently registered parameters. */
 	FORCEINLINE TArray<UAmbiverseParameter*> GetRegisteredParameters() const { return ParameterRegistry; }
+
+	/** Returns the parameters whose value changed during the last tick. */
+	FORCEINLINE const TArray<UAmbiverseParameter*>& GetChangedParameters() const { return ChangedParameters; }
+
+	/** Returns the mailbox that can be used to set parameter values from a thread other than the game thread.
+	 *	The mailbox may be kept alive by the producer, values that are set after the subsystem is destroyed are ignored. */
+	FORCEINLINE TSharedRef<FAmbiverseParameterMailbox, ESPMode::ThreadSafe> GetParameterMailbox() const { return ParameterMailbox; }
 };
@@ -8,7 +8,9 @@
 #include "GameFramework/Actor.h"
 #include "AmbiverseSoundSource.generated.h"
 
+class UAmbiverseElement;
 class UAmbiverseLayer;
+class UAmbiverseParameter;
 class UAmbiverseSoundSourceManager;
 
 UCLASS(Blueprintable, BlueprintType, NotPlaceable, ClassGroup = "Ambiverse")
@@ -44,6 +46,13 @@ private:
 	UPROPERTY()
 	UAmbiverseLayer* AmbiverseLayer {nullptr};
 
+	/** The element the sound source is playing. */
+	UPROPERTY()
+	UAmbiverseElement* AmbiverseElement {nullptr};
+
+	/** True while the audio engine has virtualized the sound of this source. */
+	bool IsSoundVirtualized {false};
+
 public:	
 	AAmbiverseSoundSource();
 
@@ -62,6 +71,16 @@ public:
 		if (!AudioComponent) { return; }
 		AudioComponent->SetVolumeMultiplier(NewVolume);
 	}
+
+	/** Fades out the sound. The sound source is returned to the pool once the sound has stopped. */
+	void FadeOut(const float Duration);
+
+	/** Sends the values of the parameters the element forwards to the inputs of the sound, in a single batch.
+	 *	@param ChangedParameters If provided, only the forwarded parameters in this array are sent. */
+	void ForwardParameters(const TArray<UAmbiverseParameter*>* ChangedParameters = nullptr);
+
+	FORCEINLINE bool IsVirtualized() const { return IsSoundVirtualized; }
+	FORCEINLINE const UAmbiverseLayer* GetLayer() const { return AmbiverseLayer; }
 	
 protected:
 	virtual void BeginPlay() override;
@@ -75,4 +94,7 @@ protected:
 private:
 	UFUNCTION()
 	void HandleOnAudioFinishedPlaying();
+
+	UFUNCTION()
+	void HandleOnAudioVirtualizationChanged(bool IsVirtualized);
 };
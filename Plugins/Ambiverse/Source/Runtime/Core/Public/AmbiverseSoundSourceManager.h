@@ -10,7 +10,7 @@
 class AAmbiverseSoundSource;
 
 UCLASS()
-class UAmbiverseSoundSourceManager : public UAmbiverseSubsystemComponent
+class AMBIVERSE_API UAmbiverseSoundSourceManager : public UAmbiverseSubsystemComponent
 {
 	GENERATED_BODY()
 
@@ -30,14 +30,32 @@ private:
 #endif
 
 public:
+	virtual void Tick(const float DeltaTime) override;
+	
 	void InitiateSoundSource(FAmbiverseSoundSourceData& SoundSourceData);
 
 	UFUNCTION(BlueprintCallable)
 	void ReleaseToPool(AAmbiverseSoundSource* SoundSource);
 
+	/** Fades out all sound sources of a layer. The sound sources return to the pool once they have stopped. */
+	void ReleaseLayerSoundSources(const UAmbiverseLayer* Layer, const float FadeOutDuration);
+
 #if !UE_BUILD_SHIPPING
 	void SetSoundSourceVisualisationEnabled(const bool IsEnabled);
 #endif
 
+	/** Returns the number of active sound sources that are currently virtualized by the audio engine. */
+	int32 GetVirtualSoundSourceCount() const;
+
+private:
+	/** Sends the parameters that changed during this tick to the active sound sources that forward them. */
+	void ForwardParameters();
+
+	/** Takes a sound source from the pool, or spawns a new one if the pool is empty. */
+	AAmbiverseSoundSource* AcquireSoundSource(bool& IsSpawned);
+
+public:
 	FORCEINLINE TArray<AAmbiverseSoundSource*> GetActiveSoundSources() const { return ActiveSoundSources; }
+	FORCEINLINE int32 GetActiveSoundSourceCount() const { return ActiveSoundSources.Num(); }
+	FORCEINLINE int32 GetPooledSoundSourceCount() const { return Pool.Num(); }
 };
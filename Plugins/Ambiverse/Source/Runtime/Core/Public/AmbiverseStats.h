@@ -0,0 +1,69 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(AMBIVERSE_API, Ambiverse);
+
+DECLARE_STATS_GROUP(TEXT("Ambiverse"), STATGROUP_Ambiverse, STATCAT_Advanced);
+
+/** Cycle counters. */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Subsystem Tick"), STAT_AmbiverseSubsystemTick, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Layer Tick"), STAT_AmbiverseLayerTick, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Parameter Evaluation"), STAT_AmbiverseParameterEvaluation, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sound Selection"), STAT_AmbiverseSoundSelection, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Distribution"), STAT_AmbiverseDistribution, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tracing"), STAT_AmbiverseTracing, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pool Acquire"), STAT_AmbiversePoolAcquire, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Actor Spawn"), STAT_AmbiverseActorSpawn, STATGROUP_Ambiverse, AMBIVERSE_API);
+
+/** Counters that are set every tick. */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Layers"), STAT_AmbiverseActiveLayers, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Scheduled Events"), STAT_AmbiverseScheduledEvents, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Fires Per Second"), STAT_AmbiverseFiresPerSecond, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Voices"), STAT_AmbiverseActiveVoices, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Virtual Voices"), STAT_AmbiverseVirtualVoices, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled Voices"), STAT_AmbiversePooledVoices, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Bed Voices"), STAT_AmbiverseBedVoices, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Far Field Voices"), STAT_AmbiverseFarFieldVoices, STATGROUP_Ambiverse, AMBIVERSE_API);
+
+/** Counters that are accumulated during a single tick. */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Fires"), STAT_AmbiverseFires, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Spawns"), STAT_AmbiverseSpawns, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pool Misses"), STAT_AmbiversePoolMisses, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Traces"), STAT_AmbiverseTraces, STATGROUP_Ambiverse, AMBIVERSE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Deferred Events"), STAT_AmbiverseDeferredEvents, STATGROUP_Ambiverse, AMBIVERSE_API);
+
+/** Counters gathered by the AmbiverseSubsystem and its components during a single tick.
+ *	These are available in every build configuration, unlike the stats above. */
+struct FAmbiverseFrameCounters
+{
+	/** The number of procedural elements that fired. */
+	int32 Fires {0};
+
+	/** The number of sound source actors that were spawned. */
+	int32 Spawns {0};
+
+	/** The number of sound sources that could not be acquired from the pool. */
+	int32 PoolMisses {0};
+
+	/** The number of scene queries that were issued. */
+	int32 Traces {0};
+
+	/** The number of elements whose missed events were deferred to the next tick by av.Scheduler.MaxCatchUpFires. */
+	int32 DeferredEvents {0};
+
+	/** The time spent ticking the active layers, in milliseconds. */
+	float LayerTickTime {0.0f};
+
+	/** The number of voices playing beds, sampled at the end of the tick. */
+	int32 BedVoices {0};
+
+	/** The number of shared far field voices, sampled at the end of the tick. */
+	int32 FarFieldVoices {0};
+
+	void Reset() { *this = FAmbiverseFrameCounters(); }
+};
@@ -3,6 +3,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "AmbiverseListenerState.h"
+#include "AmbiverseStats.h"
 #include "Subsystems/WorldSubsystem.h"
 #include "AmbiverseSubsystem.generated.h"
 
@@ -10,8 +12,16 @@ class UAmbiverseVisualisationComponent;
 class UAmbiverseDistributorManager;
 class UAmbiverseLayerManager;
 class UAmbiverseParameterManager;
+class UAmbiverseBedManager;
+class UAmbiverseFarFieldManager;
 class UAmbiverseSoundSourceManager;
 class UAmbiverseLayer;
+struct FAmbiverseProceduralElement;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnListenerViewTargetChangedDelegate, AActor*, ViewTarget);
+
+/** Called for every procedural element that fires, with the time in seconds by which it overshot its scheduled time. */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnAmbiverseElementFired, const UAmbiverseLayer*, const FAmbiverseProceduralElement&, float);
 
 UCLASS(Transient, ClassGroup = "Ambiverse")
 class AMBIVERSE_API UAmbiverseSubsystem : public UTickableWorldSubsystem
@@ -34,23 +44,79 @@ private:
 	UPROPERTY()
 	UAmbiverseDistributorManager* DistributorManager {nullptr};
 
+	UPROPERTY()
+	UAmbiverseBedManager* BedManager {nullptr};
+
+	UPROPERTY()
+	UAmbiverseFarFieldManager* FarFieldManager {nullptr};
+
 #if !UE_BUILD_SHIPPING
 	TStrongObjectPtr<UAmbiverseVisualisationComponent> VisualisationComponent {nullptr};
 #endif
 
+	/** Snapshots of all listeners, refreshed at the start of every tick. The first listener is the primary listener. */
+	TArray<FAmbiverseListenerState> Listeners;
+
+	/** Actors that are used as a listener in addition to the local player controllers, such as capture cameras. */
+	UPROPERTY(Transient)
+	TArray<TWeakObjectPtr<AActor>> ExternalListeners;
+
+	/** Counters for the current tick. These are reset at the start of every tick. */
+	FAmbiverseFrameCounters FrameCounters;
+
+	/** Counters of the last completed tick. */
+	FAmbiverseFrameCounters LastFrameCounters;
+
+	/** Exponentially smoothed number of procedural elements fired per second. */
+	float FiresPerSecond {0.0f};
+
+	/** The random stream used to schedule procedural elements. */
+	FRandomStream RandomStream;
+
+	/** If true, procedural elements are scheduled and fired without placing or playing any sounds. */
+	bool IsSimulating {false};
+
 public:
+	/** Called when the view target of the primary listener changes. */
+	UPROPERTY(BlueprintAssignable)
+	FOnListenerViewTargetChangedDelegate OnListenerViewTargetChanged;
+
+	FOnAmbiverseElementFired OnElementFired;
+	
 	UAmbiverseSubsystem();
 	
 	virtual TStatId GetStatId() const override
 	{
-		RETURN_QUICK_DECLARE_CYCLE_STAT(UAmbiverseSubsystem, STATGROUP_Tickables);
+		return GET_STATID(STAT_AmbiverseSubsystemTick);
 	}
 
-	/** Processes an ambience event and updates the queue for an ambience layer. */
-	UFUNCTION()
-	void ProcessProceduralElement(UAmbiverseLayer* Layer,  FAmbiverseProceduralElement& ProceduralElement);
+	/** Processes an ambience event and updates the queue for an ambience layer. Elements are identified by their index in the layer. */
+	void ProcessProceduralElement(UAmbiverseLayer* Layer, const int32 ElementIndex, const TArray<FAmbiverseListenerState>& ListenerStates);
 	
-	void SetNewTimeForProceduralElement(FAmbiverseProceduralElement& ProceduralElement, UAmbiverseLayer* Layer);
+	void SetNewTimeForProceduralElement(UAmbiverseLayer* Layer, const int32 ElementIndex);
+
+	/** Sets the time of a procedural element as if its layer had already been active for a long time. */
+	void WarmUpProceduralElement(UAmbiverseLayer* Layer, const int32 ElementIndex);
+
+	/** Reseeds the random stream used to schedule procedural elements, so a session can be reproduced. */
+	void SetRandomSeed(const int32 Seed);
+
+	/** Enables or disables simulation mode. In simulation mode, elements fire without being placed or played,
+	 *	which allows long stretches of layer time to be evaluated quickly. */
+	void SetSimulationMode(const bool IsEnabled);
+
+	/** Logs the counters of the last tick. Used by av.DumpStats. */
+	void DumpStats() const;
+
+	/** Adds an actor as an additional listener, for example a capture camera that is not possessed by a player controller. */
+	UFUNCTION(BlueprintCallable, Category = "Ambiverse")
+	void RegisterListener(AActor* Listener);
+
+	UFUNCTION(BlueprintCallable, Category = "Ambiverse")
+	void UnregisterListener(AActor* Listener);
+
+	/** Returns true if a location is within the given distance of any valid listener. */
+	static bool IsAudibleToAnyListener(const TArray<FAmbiverseListenerState>& ListenerStates, const FVector& Location, const float MaxDistance);
 
 private:
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
@@ -62,14 +128,34 @@ private:
 	
 	static float GetSoundVolume(const UAmbiverseLayer* Layer, const FAmbiverseProceduralElement& ProceduralElement);
 
-	UFUNCTION()
-	void HandleParameterChanged();
+	void UpdateListenerStates();
+
+	/** Updates the smoothed counters and publishes all counters to the stats system. */
+	void UpdateStats(const float DeltaTime);
+
+	/** Returns the index of the listener a procedural element should be placed around. */
+	int32 SelectListener(const UAmbiverseLayer* Layer, FAmbiverseProceduralElement& ProceduralElement, const TArray<FAmbiverseListenerState>& ListenerStates) const;
+
+	/** Returns the density multiplier for a layer that is shared between all listeners. */
+	float GetListenerDensityScalar(const UAmbiverseLayer* Layer) const;
 
 public:
+	/** Returns the multiplier that converts an interval of a procedural element into a time, based on its parameters and the listeners. */
+	float GetDensityModifier(const UAmbiverseLayer* Layer, const int32 ElementIndex) const;
+
 	FORCEINLINE UAmbiverseLayerManager* GetLayerManager() const { return LayerManager; }
 	FORCEINLINE UAmbiverseParameterManager* GetParameterManager() const { return ParameterManager; }
 	FORCEINLINE UAmbiverseSoundSourceManager* GetSoundSourceManager() const { return SoundSourceManager; }
 	FORCEINLINE UAmbiverseDistributorManager* GetDistributorManager() const { return DistributorManager; }
+	FORCEINLINE UAmbiverseBedManager* GetBedManager() const { return BedManager; }
+	FORCEINLINE UAmbiverseFarFieldManager* GetFarFieldManager() const { return FarFieldManager; }
+	FORCEINLINE const FRandomStream& GetRandomStream() const { return RandomStream; }
+	FORCEINLINE const FAmbiverseListenerState& GetListenerState() const { return Listeners[0]; }
+	FORCEINLINE const TArray<FAmbiverseListenerState>& GetListenerStates() const { return Listeners; }
+	FORCEINLINE FAmbiverseFrameCounters& GetFrameCounters() { return FrameCounters; }
+	FORCEINLINE const FAmbiverseFrameCounters& GetLastFrameCounters() const { return LastFrameCounters; }
+	FORCEINLINE float GetFiresPerSecond() const { return FiresPerSecond; }
+	FORCEINLINE bool IsSimulationMode() const { return IsSimulating; }
 };
 
 
@@ -0,0 +1,72 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Config.h"
+#include "Trace/Trace.h"
+
+#if UE_TRACE_ENABLED && !UE_BUILD_SHIPPING
+#define AMBIVERSE_TRACE_ENABLED 1
+#else
+#define AMBIVERSE_TRACE_ENABLED 0
+#endif
+
+class UAmbiverseLayer;
+class UAmbiverseParameter;
+class USoundBase;
+struct FAmbiverseProceduralElement;
+struct FAmbiverseSoundSourceData;
+
+/** How a sound source request was resolved. */
+enum class EAmbiverseTraceVoiceResult : uint8
+{
+	/** The sound source was taken from the pool. */
+	Pooled,
+	/** A new sound source actor was spawned. */
+	Spawned,
+	/** No sound source could be acquired, and the sound was dropped. */
+	Dropped
+};
+
+#if AMBIVERSE_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(AmbiverseChannel, AMBIVERSE_API);
+
+/** Emits Ambiverse events on the AmbiverseChannel trace channel. Enable it with -trace=Ambiverse.
+ *	Names are sent once as important events and referenced by ID afterwards, which keeps the per-event records small. */
+struct AMBIVERSE_API FAmbiverseTrace
+{
+	static void OutputElementFired(const UAmbiverseLayer* Layer, const FAmbiverseProceduralElement& ProceduralElement, const USoundBase* Sound,
+		const FVector& Location, const float DeferralLatency);
+
+	static void OutputVoiceRequest(const FAmbiverseSoundSourceData& SoundSourceData, const EAmbiverseTraceVoiceResult Result);
+
+	static void OutputParameterChanged(const UAmbiverseParameter* Parameter, const float Value);
+
+	/** Forgets which names have been sent, so a new trace session receives them again. Called when a trace starts. */
+	static void ResetOutputNames();
+
+private:
+	static uint64 OutputName(const FName ObjectName);
+
+	static TSet<uint64> OutputNameIds;
+};
+
+#define AMBIVERSE_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, AmbiverseChannel)
+#define TRACE_AMBIVERSE_ELEMENT_FIRED(Layer, ProceduralElement, Sound, Location, DeferralLatency) \
+	FAmbiverseTrace::OutputElementFired(Layer, ProceduralElement, Sound, Location, DeferralLatency)
+#define TRACE_AMBIVERSE_VOICE_REQUEST(SoundSourceData, Result) \
+	FAmbiverseTrace::OutputVoiceRequest(SoundSourceData, Result)
+#define TRACE_AMBIVERSE_PARAMETER_CHANGED(Parameter, Value) \
+	FAmbiverseTrace::OutputParameterChanged(Parameter, Value)
+
+#else
+
+#define AMBIVERSE_TRACE_SCOPE(Name)
+#define TRACE_AMBIVERSE_ELEMENT_FIRED(Layer, ProceduralElement, Sound, Location, DeferralLatency)
+#define TRACE_AMBIVERSE_VOICE_REQUEST(SoundSourceData, Result)
+#define TRACE_AMBIVERSE_PARAMETER_CHANGED(Parameter, Value)
+
+#endif
@@ -0,0 +1,225 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseCompiledLayer.h"
+#include "Serialization/CustomVersion.h"
+
+DEFINE_LOG_CATEGORY_CLASS(FAmbiverseCompiledLayer, LogAmbiverseCompiledLayer);
+
+const FGuid FAmbiverseCompiledLayerCustomVersion::GUID(0x6C1E2A47, 0x9B3D4F85, 0xA2E07C19, 0x5D8B36F4);
+
+static FCustomVersionRegistration GRegisterAmbiverseCompiledLayerCustomVersion(FAmbiverseCompiledLayerCustomVersion::GUID,
+	FAmbiverseCompiledLayerCustomVersion::LatestVersion, TEXT("AmbiverseCompiledLayer"));
+
+void FAmbiverseCompiledModifier::Bake(const FAmbiverseParameterModifiers& ParameterModifiers)
+{
+	for (int32 Index {0}; Index < TableSize; ++Index)
+	{
+		const float Alpha {static_cast<float>(Index) / (TableSize - 1)};
+		DensityTable[Index] = ParameterModifiers.GetDensity(Alpha);
+		VolumeTable[Index] = ParameterModifiers.GetVolume(Alpha);
+	}
+}
+
+void FAmbiverseCompiledModifier::Combine(const FAmbiverseCompiledModifier& Other)
+{
+	for (int32 Index {0}; Index < TableSize; ++Index)
+	{
+		DensityTable[Index] *= Other.DensityTable[Index];
+		VolumeTable[Index] *= Other.VolumeTable[Index];
+	}
+}
+
+void FAmbiverseCompiledLayer::Compile(const TArray<FAmbiverseProceduralElement>& ProceduralElements,
+	const TArray<FAmbiverseParameterModifiers>& ParameterModifiers)
+{
+	Reset();
+
+	/** Adds a modifier to the span of the element that is currently compiled. Modifiers of the same parameter are combined into one. */
+	auto AddModifier = [this](FAmbiverseCompiledElement& Element, const FAmbiverseParameterModifiers& ParameterModifier)
+	{
+		if (!ParameterModifier.Parameter) { return; }
+		
+		FAmbiverseCompiledModifier Modifier;
+		Modifier.ParameterIndex = Parameters.AddUnique(ParameterModifier.Parameter);
+		Modifier.Bake(ParameterModifier);
+
+		Element.ParameterMask |= Modifier.ParameterIndex < 64 ? uint64(1) << Modifier.ParameterIndex : MAX_uint64;
+
+		for (int32 Index {Element.FirstModifier}; Index < Modifiers.Num(); ++Index)
+		{
+			if (Modifiers[Index].ParameterIndex == Modifier.ParameterIndex)
+			{
+				Modifiers[Index].Combine(Modifier);
+				return;
+			}
+		}
+		
+		Modifiers.Add(Modifier);
+	};
+
+	Elements.Reserve(ProceduralElements.Num());
+	
+	for (const FAmbiverseProceduralElement& ProceduralElement : ProceduralElements)
+	{
+		FAmbiverseCompiledElement& Element {Elements.AddDefaulted_GetRef()};
+		Element.FirstVariant = Variants.Num();
+		Element.FirstModifier = Modifiers.Num();
+
+		for (const FAmbiverseParameterModifiers& ParameterModifier : ParameterModifiers)
+		{
+			AddModifier(Element, ParameterModifier);
+		}
+		for (const FAmbiverseParameterModifiers& ParameterModifier : ProceduralElement.Parameters)
+		{
+			AddModifier(Element, ParameterModifier);
+		}
+		
+		Element.ModifierCount = Modifiers.Num() - Element.FirstModifier;
+
+		if (!ProceduralElement.Element) { continue; }
+
+		int32 TotalWeight {0};
+		for (const TPair<UMetaSoundSource*, int>& SoundWeightPair : ProceduralElement.Element->Sounds)
+		{
+			if (!SoundWeightPair.Key) { continue; }
+			
+			FAmbiverseCompiledVariant& Variant {Variants.AddDefaulted_GetRef()};
+			Variant.SoundIndex = Sounds.AddUnique(TSoftObjectPtr<UMetaSoundSource>(SoundWeightPair.Key));
+			Variant.Probability = FMath::Max(0, SoundWeightPair.Value);
+			TotalWeight += FMath::Max(0, SoundWeightPair.Value);
+		}
+
+		Element.VariantCount = Variants.Num() - Element.FirstVariant;
+		if (Element.VariantCount == 0) { continue; }
+
+		/** Builds the alias table with Vose's method. Every slot holds its own variant with some probability and an alias for the remainder.
+		 *	The probabilities are first scaled so the average slot has a probability of one. */
+		TArrayView<FAmbiverseCompiledVariant> ElementVariants {MakeArrayView(&Variants[Element.FirstVariant], Element.VariantCount)};
+		
+		TArray<int32> Small;
+		TArray<int32> Large;
+		
+		for (int32 Index {0}; Index < ElementVariants.Num(); ++Index)
+		{
+			FAmbiverseCompiledVariant& Variant {ElementVariants[Index]};
+			Variant.Probability = TotalWeight > 0 ? Variant.Probability * ElementVariants.Num() / TotalWeight : 1.0f;
+			Variant.Alias = Index;
+			(Variant.Probability < 1.0f ? Small : Large).Add(Index);
+		}
+
+		while (!Small.IsEmpty() && !Large.IsEmpty())
+		{
+			const int32 SmallIndex {Small.Pop(false)};
+			const int32 LargeIndex {Large.Last()};
+			
+			ElementVariants[SmallIndex].Alias = LargeIndex;
+			ElementVariants[LargeIndex].Probability -= 1.0f - ElementVariants[SmallIndex].Probability;
+
+			if (ElementVariants[LargeIndex].Probability < 1.0f)
+			{
+				Large.Pop(false);
+				Small.Add(LargeIndex);
+			}
+		}
+
+		/** Slots that remain are only off by rounding errors. */
+		for (const int32 Index : Small) { ElementVariants[Index].Probability = 1.0f; }
+		for (const int32 Index : Large) { ElementVariants[Index].Probability = 1.0f; }
+	}
+
+	IsCompiled = true;
+}
+
+void FAmbiverseCompiledLayer::Reset()
+{
+	Elements.Reset();
+	Modifiers.Reset();
+	Variants.Reset();
+	Sounds.Reset();
+	Parameters.Reset();
+	IsCompiled = false;
+}
+
+UMetaSoundSource* FAmbiverseCompiledLayer::SelectSound(const int32 ElementIndex, const FRandomStream& RandomStream) const
+{
+	if (!Elements.IsValidIndex(ElementIndex)) { return nullptr; }
+
+	const FAmbiverseCompiledElement& Element {Elements[ElementIndex]};
+	if (Element.VariantCount == 0) { return nullptr; }
+
+	const int32 Slot {RandomStream.RandHelper(Element.VariantCount)};
+	const FAmbiverseCompiledVariant& Variant {Variants[Element.FirstVariant + Slot]};
+	
+	const int32 SelectedVariant {RandomStream.FRand() < Variant.Probability ? Slot : Variant.Alias};
+	return Sounds[Variants[Element.FirstVariant + SelectedVariant].SoundIndex].Get();
+}
+
+void FAmbiverseCompiledLayer::GetParameterScalars(const int32 ElementIndex, float& DensityScalar, float& VolumeScalar) const
+{
+	if (!Elements.IsValidIndex(ElementIndex)) { return; }
+
+	const FAmbiverseCompiledElement& Element {Elements[ElementIndex]};
+	for (const FAmbiverseCompiledModifier& Modifier : MakeArrayView(Modifiers.GetData() + Element.FirstModifier, Element.ModifierCount))
+	{
+		const UAmbiverseParameter* Parameter {Parameters[Modifier.ParameterIndex]};
+		if (!Parameter) { continue; }
+
+		DensityScalar *= FAmbiverseCompiledModifier::Evaluate(Modifier.DensityTable, Parameter->ParameterValue);
+		VolumeScalar *= FAmbiverseCompiledModifier::Evaluate(Modifier.VolumeTable, Parameter->ParameterValue);
+	}
+}
+
+uint64 FAmbiverseCompiledLayer::GetParameterMask(const TArray<UAmbiverseParameter*>& ParameterArray) const
+{
+	uint64 Mask {0};
+	for (int32 Index {0}; Index < Parameters.Num(); ++Index)
+	{
+		if (ParameterArray.Contains(Parameters[Index]))
+		{
+			Mask |= Index < 64 ? uint64(1) << Index : MAX_uint64;
+		}
+	}
+	return Mask;
+}
+
+bool FAmbiverseCompiledLayer::Serialize(FArchive& Ar)
+{
+	Ar.UsingCustomVersion(FAmbiverseCompiledLayerCustomVersion::GUID);
+
+	/** The tables are read in bulk, so data of an unknown layout can't be read at all. */
+	if (Ar.IsLoading() && Ar.CustomVer(FAmbiverseCompiledLayerCustomVersion::GUID) > FAmbiverseCompiledLayerCustomVersion::LatestVersion)
+	{
+		UE_LOG(LogAmbiverseCompiledLayer, Error, TEXT("Serialize: Compiled layer version %d is newer than the supported version %d."),
+			Ar.CustomVer(FAmbiverseCompiledLayerCustomVersion::GUID), static_cast<int32>(FAmbiverseCompiledLayerCustomVersion::LatestVersion));
+		Reset();
+		Ar.SetError();
+		return true;
+	}
+	
+	Ar << IsCompiled;
+	
+	Elements.BulkSerialize(Ar);
+	Modifiers.BulkSerialize(Ar);
+	Variants.BulkSerialize(Ar);
+	
+	/** Older versions stored hard references to the sounds, which are converted on load. */
+	if (Ar.IsLoading() && Ar.CustomVer(FAmbiverseCompiledLayerCustomVersion::GUID) < FAmbiverseCompiledLayerCustomVersion::SoftSoundReferences)
+	{
+		TArray<UMetaSoundSource*> HardSounds;
+		Ar << HardSounds;
+		
+		Sounds.Reset(HardSounds.Num());
+		for (UMetaSoundSource* Sound : HardSounds)
+		{
+			Sounds.Add(Sound);
+		}
+	}
+	else
+	{
+		Ar << Sounds;
+	}
+	
+	Ar << Parameters;
+	
+	return true;
+}
@@ -1,21 +1,85 @@
 ﻿// Copyright (c) 2023-present Tim Verberne. All rights reserved.
 
 #include "AmbiverseSoundDistributionData.h"
+#include "AmbiverseSpawnPointTable.h"
+#include "Sound/SoundBase.h"
 
 FTransform FAmbiverseSoundDistributionData::GetSoundTransform(const FAmbiverseSoundDistributionData& DistributionData,
 	const FVector& ListenerLocation)
+{
+	int32 Cursor {INDEX_NONE};
+	return GetSoundTransform(DistributionData, ListenerLocation, Cursor);
+}
+
+FTransform FAmbiverseSoundDistributionData::GetSoundTransform(const FAmbiverseSoundDistributionData& DistributionData,
+	const FVector& ListenerLocation, int32& Cursor)
 {
 	FTransform Transform;
 
-	const double X {FMath::RandRange(-DistributionData.HorizontalRange.X, DistributionData.HorizontalRange.X)};
-	const double Y {FMath::RandRange(-DistributionData.HorizontalRange.Y, DistributionData.HorizontalRange.Y)};
-	
-	double Z {FMath::RandRange(DistributionData.VerticalRange * -0.5, DistributionData.VerticalRange * 0.5)};
-	Z += DistributionData.VerticalOffset;
+	const float HalfVerticalRange {DistributionData.VerticalRange * 0.5f};
+	FVector Offset;
+
+	if (DistributionData.UseSpawnPointTable)
+	{
+		if (DistributionData.Shape == EAmbiverseDistributionShape::Annulus)
+		{
+			const FAmbiverseSpawnPoint& Point {FAmbiverseSpawnPointTable::GetNextPoint(FAmbiverseSpawnPointTable::GetAnnulusTable(), Cursor)};
+			const FVector2D PointInAnnulus {FAmbiverseSpawnPointTable::GetPointInAnnulus(Point,
+				DistributionData.HorizontalRange.X, DistributionData.HorizontalRange.Y)};
+			
+			Offset = FVector(PointInAnnulus.X, PointInAnnulus.Y, Point.Position.Z * HalfVerticalRange);
+		}
+		else
+		{
+			const FAmbiverseSpawnPoint& Point {FAmbiverseSpawnPointTable::GetNextPoint(FAmbiverseSpawnPointTable::GetBoxTable(), Cursor)};
+			
+			Offset = FVector(Point.Position.X * DistributionData.HorizontalRange.X, Point.Position.Y * DistributionData.HorizontalRange.Y,
+				Point.Position.Z * HalfVerticalRange);
+		}
+	}
+	else
+	{
+		if (DistributionData.Shape == EAmbiverseDistributionShape::Annulus)
+		{
+			FAmbiverseSpawnPoint Point;
+			FMath::SinCos(&Point.Direction.Y, &Point.Direction.X, FMath::RandRange(0.0f, 2 * PI));
+			Point.AreaFraction = FMath::FRand();
+			
+			const FVector2D PointInAnnulus {FAmbiverseSpawnPointTable::GetPointInAnnulus(Point,
+				DistributionData.HorizontalRange.X, DistributionData.HorizontalRange.Y)};
+			
+			Offset = FVector(PointInAnnulus.X, PointInAnnulus.Y, 0.0);
+		}
+		else
+		{
+			Offset.X = FMath::RandRange(-DistributionData.HorizontalRange.X, DistributionData.HorizontalRange.X);
+			Offset.Y = FMath::RandRange(-DistributionData.HorizontalRange.Y, DistributionData.HorizontalRange.Y);
+		}
+		
+		Offset.Z = FMath::RandRange(-HalfVerticalRange, HalfVerticalRange);
+	}
+
+	Offset.Z += DistributionData.VerticalOffset;
 
-	const FVector Location {FVector(X, Y, Z) + ListenerLocation};
+	const FVector Location {Offset + ListenerLocation};
 
 	Transform.SetLocation(Location);
 	
 	return Transform;
 }
+
+FVector FAmbiverseSoundDistributionData::GetPredictionOffset(const FAmbiverseSoundDistributionData& DistributionData,
+	const FVector& ListenerVelocity, float SoundDuration)
+{
+	if (!DistributionData.EnablePredictivePlacement) { return FVector::ZeroVector; }
+
+	/** Looping and procedural sounds report an infinite or zero duration. */
+	if (SoundDuration <= 0.0f || SoundDuration >= INDEFINITELY_LOOPING_DURATION)
+	{
+		SoundDuration = DistributionData.FallbackSoundDuration;
+	}
+
+	const FVector Offset {ListenerVelocity * SoundDuration * DistributionData.PredictionBias};
+	
+	return Offset.GetClampedToMaxSize(DistributionData.MaxPredictionDistance);
+}
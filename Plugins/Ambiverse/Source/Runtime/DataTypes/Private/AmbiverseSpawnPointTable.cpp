@@ -0,0 +1,89 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#include "AmbiverseSpawnPointTable.h"
+
+namespace AmbiverseSpawnPointTable
+{
+	/** The number of candidates generated for every existing point when selecting the next point. */
+	constexpr int32 CandidatesPerPoint {10};
+
+	/** Limits the cost of generating the tables. The quality of the point set barely improves beyond this. */
+	constexpr int32 MaxCandidateCount {256};
+
+	/** A fixed seed, so the tables are identical between runs. */
+	constexpr int32 Seed {0x41564E53};
+
+	/** Generates a progressive blue-noise point set with Mitchell's best-candidate algorithm.
+	 *	For every new point, a number of random candidates is generated and the candidate furthest away from all existing points is kept. */
+	template <typename SamplerType>
+	TArray<FAmbiverseSpawnPoint> Generate(SamplerType&& Sampler)
+	{
+		FRandomStream RandomStream {Seed};
+
+		TArray<FAmbiverseSpawnPoint> Points;
+		Points.Reserve(FAmbiverseSpawnPointTable::TableSize);
+		Points.Add(Sampler(RandomStream));
+
+		while (Points.Num() < FAmbiverseSpawnPointTable::TableSize)
+		{
+			FAmbiverseSpawnPoint BestCandidate;
+			float BestDistanceSquared {-1.0f};
+
+			const int32 CandidateCount {FMath::Min(Points.Num() * CandidatesPerPoint, MaxCandidateCount)};
+			for (int32 i {0}; i < CandidateCount; ++i)
+			{
+				const FAmbiverseSpawnPoint Candidate {Sampler(RandomStream)};
+
+				float NearestDistanceSquared {FLT_MAX};
+				for (const FAmbiverseSpawnPoint& Point : Points)
+				{
+					NearestDistanceSquared = FMath::Min(NearestDistanceSquared, FVector3f::DistSquared(Candidate.Position, Point.Position));
+				}
+
+				if (NearestDistanceSquared > BestDistanceSquared)
+				{
+					BestDistanceSquared = NearestDistanceSquared;
+					BestCandidate = Candidate;
+				}
+			}
+
+			Points.Add(BestCandidate);
+		}
+
+		return Points;
+	}
+
+	FAmbiverseSpawnPoint SampleBox(FRandomStream& RandomStream)
+	{
+		FAmbiverseSpawnPoint Point;
+		Point.Position = FVector3f(RandomStream.FRandRange(-1.0f, 1.0f), RandomStream.FRandRange(-1.0f, 1.0f), RandomStream.FRandRange(-1.0f, 1.0f));
+		return Point;
+	}
+
+	FAmbiverseSpawnPoint SampleCylinder(FRandomStream& RandomStream)
+	{
+		FAmbiverseSpawnPoint Point;
+		
+		const float Angle {RandomStream.FRandRange(0.0f, 2 * PI)};
+		FMath::SinCos(&Point.Direction.Y, &Point.Direction.X, Angle);
+		
+		/** The area fraction is uniform over the disc, so the radius is the square root of it. */
+		Point.AreaFraction = RandomStream.FRand();
+		
+		const float Radius {FMath::Sqrt(Point.AreaFraction)};
+		Point.Position = FVector3f(Point.Direction.X * Radius, Point.Direction.Y * Radius, RandomStream.FRandRange(-1.0f, 1.0f));
+		return Point;
+	}
+}
+
+const TArray<FAmbiverseSpawnPoint>& FAmbiverseSpawnPointTable::GetBoxTable()
+{
+	static const TArray<FAmbiverseSpawnPoint> Table {AmbiverseSpawnPointTable::Generate(&AmbiverseSpawnPointTable::SampleBox)};
+	return Table;
+}
+
+const TArray<FAmbiverseSpawnPoint>& FAmbiverseSpawnPointTable::GetAnnulusTable()
+{
+	static const TArray<FAmbiverseSpawnPoint> Table {AmbiverseSpawnPointTable::Generate(&AmbiverseSpawnPointTable::SampleCylinder)};
+	return Table;
+}
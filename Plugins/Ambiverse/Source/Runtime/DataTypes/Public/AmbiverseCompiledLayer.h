@@ -0,0 +1,164 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AmbiverseParameter.h"
+#include "AmbiverseProceduralElement.h"
+#include "AmbiverseCompiledLayer.generated.h"
+
+class UMetaSoundSource;
+
+/** The serialization versions of compiled layers. Add a version whenever the layout of the tables changes. */
+struct AMBIVERSE_API FAmbiverseCompiledLayerCustomVersion
+{
+	enum Type
+	{
+		/** Compiled layers saved before the version was added. Their layout is the same as the initial version. */
+		BeforeCustomVersionWasAdded = 0,
+		
+		InitialVersion,
+
+		/** The sound table holds soft references, so the sounds are kept alive by the elements only and are not referenced twice. */
+		SoftSoundReferences,
+
+		// -----<new versions can be added above this line>-------------------------------------------------
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	static const FGuid GUID;
+};
+
+/** A procedural element of a compiled layer. */
+struct FAmbiverseCompiledElement
+{
+	/** The range of this element's sound variants in the alias table. */
+	int32 FirstVariant {0};
+	int32 VariantCount {0};
+
+	/** The range of this element's modifiers in the modifier table. The modifiers of the layer and the element are merged into one span. */
+	int32 FirstModifier {0};
+	int32 ModifierCount {0};
+
+	/** A bit for every index in the parameter table this element depends on. Parameters beyond the width of the mask set every bit. */
+	uint64 ParameterMask {0};
+
+	friend FArchive& operator<<(FArchive& Ar, FAmbiverseCompiledElement& Element)
+	{
+		return Ar << Element.FirstVariant << Element.VariantCount << Element.FirstModifier << Element.ModifierCount << Element.ParameterMask;
+	}
+};
+
+/** A parameter modifier of a compiled layer.
+ *	Both linear ranges and curves are baked into lookup tables over the normalized parameter value, so every modifier is evaluated the same way. */
+struct FAmbiverseCompiledModifier
+{
+	/** The number of samples in a lookup table. The samples are spaced evenly from 0 to 1, and interpolated linearly. */
+	static constexpr int32 TableSize {33};
+	
+	/** The index of the parameter in the parameter table of the compiled layer. */
+	int32 ParameterIndex {INDEX_NONE};
+	
+	float DensityTable[TableSize] {};
+	float VolumeTable[TableSize] {};
+
+	/** Samples the multipliers of a modifier into the lookup tables. */
+	void Bake(const FAmbiverseParameterModifiers& ParameterModifiers);
+
+	/** Multiplies the lookup tables by those of another modifier of the same parameter. */
+	void Combine(const FAmbiverseCompiledModifier& Other);
+
+	/** Returns the interpolated value of a lookup table at a normalized parameter value. */
+	static FORCEINLINE float Evaluate(const float (&Table)[TableSize], const float Alpha)
+	{
+		const float Position {FMath::Clamp(Alpha, 0.0f, 1.0f) * (TableSize - 1)};
+		const int32 Index {FMath::Min(static_cast<int32>(Position), TableSize - 2)};
+		return FMath::Lerp(Table[Index], Table[Index + 1], Position - Index);
+	}
+
+	friend FArchive& operator<<(FArchive& Ar, FAmbiverseCompiledModifier& Modifier)
+	{
+		Ar << Modifier.ParameterIndex;
+		for (int32 Index {0}; Index < TableSize; ++Index)
+		{
+			Ar << Modifier.DensityTable[Index] << Modifier.VolumeTable[Index];
+		}
+		return Ar;
+	}
+};
+
+/** A sound variant in the alias table of a compiled layer. */
+struct FAmbiverseCompiledVariant
+{
+	/** The index of the sound in the sound table of the compiled layer. */
+	int32 SoundIndex {INDEX_NONE};
+
+	/** The probability of selecting this variant when its slot is drawn, and the variant to select otherwise, relative to the first variant of the element. */
+	float Probability {1.0f};
+	int32 Alias {0};
+
+	friend FArchive& operator<<(FArchive& Ar, FAmbiverseCompiledVariant& Variant)
+	{
+		return Ar << Variant.SoundIndex << Variant.Probability << Variant.Alias;
+	}
+};
+
+/** A flattened, immutable copy of the elements and parameter modifiers of a layer.
+ *	The tables are plain arrays that are serialized in bulk. Sounds and parameters are stored once and referenced by index.
+ *	Sound variants are stored as alias tables, so a weighted variant is selected in constant time. */
+USTRUCT()
+struct AMBIVERSE_API FAmbiverseCompiledLayer
+{
+	GENERATED_USTRUCT_BODY()
+
+	DECLARE_LOG_CATEGORY_CLASS(LogAmbiverseCompiledLayer, Log, All)
+
+private:
+	TArray<FAmbiverseCompiledElement> Elements;
+	TArray<FAmbiverseCompiledModifier> Modifiers;
+	TArray<FAmbiverseCompiledVariant> Variants;
+
+	/** Soft references, so the garbage collector does not walk the sounds of every compiled layer.
+	 *	The sounds are loaded and kept alive by the element assets of the layer. */
+	UPROPERTY()
+	TArray<TSoftObjectPtr<UMetaSoundSource>> Sounds;
+
+	UPROPERTY()
+	TArray<UAmbiverseParameter*> Parameters;
+
+	bool IsCompiled {false};
+
+public:
+	/** Builds the tables from the elements and parameter modifiers of a layer. Elements without an element asset must be removed beforehand.
+	 *	The modifiers of the layer are merged into the modifiers of every element, so an element is evaluated from a single span. */
+	void Compile(const TArray<FAmbiverseProceduralElement>& ProceduralElements, const TArray<FAmbiverseParameterModifiers>& ParameterModifiers);
+
+	void Reset();
+
+	/** Selects a weighted sound variant of an element. If the weights of an element are not positive, its variants are selected evenly.
+	 *	Returns null if the selected sound is not loaded. */
+	UMetaSoundSource* SelectSound(const int32 ElementIndex, const FRandomStream& RandomStream) const;
+
+	/** Returns the density and volume multipliers of the parameter modifiers of an element, at the current values of the parameters. */
+	void GetParameterScalars(const int32 ElementIndex, float& DensityScalar, float& VolumeScalar) const;
+
+	/** Returns a mask with a bit for every parameter of this layer that is in the given array, to test against the parameter masks of the elements. */
+	uint64 GetParameterMask(const TArray<UAmbiverseParameter*>& ParameterArray) const;
+
+	bool Serialize(FArchive& Ar);
+
+	FORCEINLINE bool GetIsCompiled() const { return IsCompiled; }
+	FORCEINLINE int32 GetElementCount() const { return Elements.Num(); }
+	FORCEINLINE uint64 GetElementParameterMask(const int32 ElementIndex) const { return Elements.IsValidIndex(ElementIndex) ? Elements[ElementIndex].ParameterMask : 0; }
+	FORCEINLINE const TArray<UAmbiverseParameter*>& GetParameters() const { return Parameters; }
+};
+
+template<>
+struct TStructOpsTypeTraits<FAmbiverseCompiledLayer> : public TStructOpsTypeTraitsBase2<FAmbiverseCompiledLayer>
+{
+	enum
+	{
+		WithSerializer = true,
+	};
+};
@@ -0,0 +1,33 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AmbiverseListenerState.generated.h"
+
+/** A snapshot of the listener, refreshed once per tick by the AmbiverseSubsystem. */
+USTRUCT(BlueprintType)
+struct FAmbiverseListenerState
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The location of the listener's camera. */
+	UPROPERTY(BlueprintReadOnly, Category = "Listener")
+	FVector Location {FVector::ZeroVector};
+
+	/** The rotation of the listener's camera. */
+	UPROPERTY(BlueprintReadOnly, Category = "Listener")
+	FRotator Rotation {FRotator::ZeroRotator};
+
+	/** The velocity of the listener's view target. */
+	UPROPERTY(BlueprintReadOnly, Category = "Listener")
+	FVector Velocity {FVector::ZeroVector};
+
+	/** The actor the listener's camera is currently viewing. */
+	UPROPERTY()
+	TWeakObjectPtr<AActor> ViewTarget {nullptr};
+
+	/** True if the snapshot was taken from a valid camera. */
+	UPROPERTY(BlueprintReadOnly, Category = "Listener")
+	bool IsValid {false};
+};
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "AmbiverseElement.h"
+#include "AmbiverseParameter.h"
 #include "AmbiverseProceduralElement.generated.h"
 
 class UAmbiverseElement;
@@ -24,6 +25,10 @@ struct FAmbiverseProceduralElement
 	 *	The play interval is randomized between these two values. */
 	UPROPERTY(EditAnywhere, Meta = (DisplayName = "Interval", ClampMin = "0"))
 	FVector2D IntervalRange {FVector2D(10, 30)};
+
+	/** Parameter modifiers that only apply to this element. They are combined with the parameter modifiers of the layer. */
+	UPROPERTY(EditAnywhere)
+	TArray<FAmbiverseParameterModifiers> Parameters;
 	
 	UPROPERTY(Transient)
 	float Time {0.0f};
@@ -32,6 +37,14 @@ struct FAmbiverseProceduralElement
 	 *	We use this time value to be able to dynamically apply parameters in real time without breaking th existing queue. */
 	UPROPERTY(Transient)
 	float ReferenceTime {0.0f};
+
+	/** The position of this element in the spawn point table. */
+	UPROPERTY(Transient)
+	int32 SpawnPointCursor {INDEX_NONE};
+
+	/** The listener this element was last placed around. */
+	UPROPERTY(Transient)
+	int32 ListenerCursor {INDEX_NONE};
 	
 	bool IsValid() const
 	{
@@ -4,13 +4,26 @@
 
 #include "AmbiverseSoundDistributionData.generated.h"
 
+/** The shape of the area around the player that an AmbienceSoundSource can play in. */
+UENUM(BlueprintType)
+enum class EAmbiverseDistributionShape : uint8
+{
+	Box			UMETA(DisplayName = "Box"),
+	Annulus		UMETA(DisplayName = "Annulus"),
+};
+
 /** Defines the area around the player that an AmbienceSoundSource can play in. */
 USTRUCT(BlueprintType)
-struct FAmbiverseSoundDistributionData
+struct AMBIVERSE_API FAmbiverseSoundDistributionData
 {
 	GENERATED_USTRUCT_BODY()
 	
-	/** Defines the horizontal range in which a sound source can play in relation to the player. */
+	/** The shape of the area in which a sound source can play. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Play Range")
+	EAmbiverseDistributionShape Shape {EAmbiverseDistributionShape::Box};
+	
+	/** Defines the horizontal range in which a sound source can play in relation to the player.
+	 *	For a box, this is the extent on the X and Y axis. For an annulus, this is the inner and outer radius. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Play Range", Meta = (ClampMin = "0"))
 	FVector2D HorizontalRange {FVector2D(500, 1000)};
 
@@ -21,6 +34,32 @@ struct FAmbiverseSoundDistributionData
 	/** Defines the vertical range in which a sound source can play in relation to the player. Is not affected by ExclusionRadius. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Play Range")
 	float VerticalRange {100.0f};
+
+	/** If true, sound sources are placed using a precomputed blue-noise point set, which spreads them more evenly than independent random values. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Play Range")
+	bool UseSpawnPointTable {true};
+
+	/** If true, sound sources are placed ahead of a moving listener, so that more of their audible lifetime is spent near the listener. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Prediction")
+	bool EnablePredictivePlacement {false};
+
+	/** The point in the lifetime of a sound at which the listener should pass it. At 0.5, the listener passes the sound halfway through its duration. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Prediction", Meta = (EditCondition = "EnablePredictivePlacement", ClampMin = "0", ClampMax = "1"))
+	float PredictionBias {0.5f};
+
+	/** The duration used for prediction if a sound has no finite duration. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Prediction", Meta = (EditCondition = "EnablePredictivePlacement", ClampMin = "0"))
+	float FallbackSoundDuration {5.0f};
+
+	/** The maximum distance a sound source can be placed ahead of the listener. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Prediction", Meta = (EditCondition = "EnablePredictivePlacement", ClampMin = "0"))
+	float MaxPredictionDistance {5000.0f};
 	
 	static FTransform GetSoundTransform(const FAmbiverseSoundDistributionData& DistributionData, const FVector& ListenerLocation);
+
+	/** Returns a transform for a sound source. The cursor is used to read from the spawn point table and is advanced for every call. */
+	static FTransform GetSoundTransform(const FAmbiverseSoundDistributionData& DistributionData, const FVector& ListenerLocation, int32& Cursor);
+
+	/** Returns the offset along the listener's velocity at which a sound with the given duration should be placed. */
+	static FVector GetPredictionOffset(const FAmbiverseSoundDistributionData& DistributionData, const FVector& ListenerVelocity, float SoundDuration);
 };
@@ -5,6 +5,7 @@
 #include "MetasoundSource.h"
 #include "AmbiverseSoundSourceData.generated.h"
 
+class UAmbiverseElement;
 class UAmbiverseLayer;
 
 /** Contains data that can be used by an AmbienceSoundSource instance. */
@@ -32,6 +33,10 @@ struct FAmbiverseSoundSourceData
 	/** The ambiverse layer responsible for initializing the soundsource. */
 	UPROPERTY()
 	UAmbiverseLayer* Layer {nullptr};
+
+	/** The element the sound belongs to. */
+	UPROPERTY()
+	UAmbiverseElement* Element {nullptr};
 	
 	/** Constructor with default values. */
 	FAmbiverseSoundSourceData()
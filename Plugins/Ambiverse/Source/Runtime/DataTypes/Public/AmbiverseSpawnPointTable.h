@@ -0,0 +1,54 @@
+// Copyright (c) 2023-present Tim Verberne. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** A single precomputed spawn point in normalized shape space. */
+struct FAmbiverseSpawnPoint
+{
+	/** The normalized position of the point. For box tables every component is in the range [-1, 1]. */
+	FVector3f Position {FVector3f::ZeroVector};
+
+	/** For annulus tables, the horizontal direction of the point from the center. */
+	FVector2f Direction {FVector2f::ZeroVector};
+
+	/** For annulus tables, the fraction of the area of the annulus that lies within the point. Used to map the point onto any annulus without clumping. */
+	float AreaFraction {0.0f};
+};
+
+/** Precomputed blue-noise point sets used to place procedural sounds.
+ *	The point sets are generated once with Mitchell's best-candidate algorithm. This produces a progressive ordering,
+ *	so any run of consecutive points is evenly spread over the shape. Elements read the table with a rotating cursor. */
+class AMBIVERSE_API FAmbiverseSpawnPointTable
+{
+public:
+	static constexpr int32 TableSize {256};
+
+	/** Returns the point set for a box with an extent of 1 on every axis. */
+	static const TArray<FAmbiverseSpawnPoint>& GetBoxTable();
+
+	/** Returns the point set for a cylinder with a radius of 1 and a half height of 1. Use AreaFraction to map a point onto an annulus. */
+	static const TArray<FAmbiverseSpawnPoint>& GetAnnulusTable();
+
+	/** Returns the point at the cursor and advances the cursor. A negative cursor is initialized to a random position in the table. */
+	static FORCEINLINE const FAmbiverseSpawnPoint& GetNextPoint(const TArray<FAmbiverseSpawnPoint>& Table, int32& Cursor)
+	{
+		if (Cursor < 0 || Cursor >= TableSize)
+		{
+			Cursor = FMath::RandHelper(TableSize);
+		}
+
+		const FAmbiverseSpawnPoint& Point {Table[Cursor]};
+		Cursor = (Cursor + 1) % TableSize;
+		return Point;
+	}
+
+	/** Maps a point from an annulus table onto an annulus with the given radii. */
+	static FORCEINLINE FVector2D GetPointInAnnulus(const FAmbiverseSpawnPoint& Point, const float InnerRadius, const float OuterRadius)
+	{
+		const float InnerRadiusSquared {FMath::Square(InnerRadius)};
+		const float Radius {FMath::Sqrt(InnerRadiusSquared + Point.AreaFraction * (FMath::Square(OuterRadius) - InnerRadiusSquared))};
+		return FVector2D(Point.Direction.X * Radius, Point.Direction.Y * Radius);
+	}
+};